@@ -0,0 +1,260 @@
+#include <Wire.h>
+#include "terminal_commander.h"
+
+// Benchmark of the Terminal Commander parsing and dispatch path.
+//
+// A ScriptStream replays a fixed script of terminal input to a Terminal
+// instance one line at a time, as fast as loop() can consume it, and
+// discards the responses.
+// The end-to-end response time and bus time of the I2C commands are measured
+// next, so a faster bus clock (Wire.setClock()) can be verified, and
+// the argument parsers are then timed against their libc counterparts.
+// Results are reported on the real Serial port. For a per-stage breakdown
+// of loop(), serialCommandProcessor() and runUserCallbacks() set
+// TERM_PROFILING to 1 in terminal_commander.h before compiling.
+
+// UART serial console communication baud rate
+#define TERM_BAUD_RATE            (115200L)
+
+// Number of script lines to replay per benchmark run
+#define BENCHMARK_COMMANDS        (2000UL)
+
+// Number of calls per argument parser benchmark
+#define BENCHMARK_PARSES          (1000UL)
+
+// Script replayed by the benchmark, one command per line
+static const char benchmark_script[] PROGMEM =
+  "led on\n"
+  "led off\n"
+  "set 12, 345; -6.78\n"
+  "nop\n"
+  "  set   a long argument list with trailing whitespace    \n"
+  "unknown command\n";
+
+// I2C commands whose end-to-end response time is measured, one per line
+static const char response_script[] PROGMEM =
+  "i2c r 50 00 00 00 00\n"
+  "scan\n"
+  "i2c dump 50 00 100\n"
+  "i2c r 50 00 #64\n";
+
+// In-memory Stream which replays a PROGMEM script and counts traffic
+class ScriptStream : public Stream {
+  public:
+    ScriptStream(const char *script, size_t length) :
+      script(script), length(length) {}
+
+    int available(void) { return (int)(this->lineEnd - this->position); }
+
+    int peek(void) {
+      if (this->position >= this->lineEnd) {
+        return -1;
+      }
+      return (int)pgm_read_byte(&this->script[this->position]);
+    }
+
+    int read(void) {
+      int c = this->peek();
+      if (c >= 0) {
+        this->position++;
+        this->bytesRead++;
+        if (c == '\n') {
+          this->linesRead++;
+        }
+      }
+      return c;
+    }
+
+    size_t write(uint8_t) {
+      this->bytesWritten++;
+      this->writeCalls++;
+      return 1;
+    }
+
+    size_t write(const uint8_t *, size_t size) {
+      this->bytesWritten += size;
+      this->writeCalls++;
+      return size;
+    }
+
+    // release the next script line, wrapping to the start of the script
+    void nextLine(void) {
+      if (this->lineEnd >= this->length) {
+        this->lineEnd = 0;
+      }
+      this->position = this->lineEnd;
+      while (this->lineEnd < this->length) {
+        if (pgm_read_byte(&this->script[this->lineEnd++]) == '\n') {
+          break;
+        }
+      }
+    }
+
+    uint32_t linesRead = 0;
+    uint32_t bytesRead = 0;
+    uint32_t bytesWritten = 0;
+    uint32_t writeCalls = 0;
+
+  private:
+    const char *script;
+    const size_t length;
+    size_t position = 0;
+    size_t lineEnd = 0;
+};
+
+ScriptStream Script(benchmark_script, sizeof(benchmark_script) - 1);
+TerminalCommander::Terminal Bench(&Script, &Wire);
+
+ScriptStream ResponseScript(response_script, sizeof(response_script) - 1);
+TerminalCommander::Terminal ResponseBench(&ResponseScript, &Wire);
+
+volatile uint32_t callback_count = 0;
+
+// volatile sinks keep the compiler from discarding the parsed values
+volatile int32_t int_sink = 0;
+volatile uint32_t hex_sink = 0;
+volatile float float_sink = 0.0f;
+
+void count_callback(char* args, size_t size) {
+  callback_count++;
+}
+
+void print_stage(const __FlashStringHelper *name,
+                 const TerminalCommander::TerminalCommanderTypes::profile_stage_t &stage) {
+  Serial.print(name);
+  Serial.print(F(": calls "));
+  Serial.print(stage.calls);
+  Serial.print(F(", avg us "));
+  Serial.print(stage.calls ? (float)stage.total_us / (float)stage.calls : 0.0f);
+  Serial.print(F(", max us "));
+  Serial.println(stage.max_us);
+}
+
+// time BENCHMARK_PARSES calls of a parser, returns average microseconds per call
+template <typename parse_fn_t>
+float time_parser(parse_fn_t parse) {
+  const uint32_t start = micros();
+  for (uint32_t k = 0; k < BENCHMARK_PARSES; k++) {
+    parse();
+  }
+  return (float)(micros() - start) / (float)BENCHMARK_PARSES;
+}
+
+void print_parser(const __FlashStringHelper *name, float parser_us, float libc_us) {
+  Serial.print(name);
+  Serial.print(F(": us "));
+  Serial.print(parser_us);
+  Serial.print(F(", libc us "));
+  Serial.println(libc_us);
+}
+
+void benchmark_parsers() {
+  using namespace TerminalCommander;
+  using namespace TerminalCommander::TerminalCommanderTypes;
+
+  static const char int_text[] = "-1234567";
+  static const char hex_text[] = "0x1F2E3D";
+  static const char float_text[] = "-6.78125";
+  const token_t int_token = { int_text, (uint8_t)(sizeof(int_text) - 1) };
+  const token_t hex_token = { hex_text, (uint8_t)(sizeof(hex_text) - 1) };
+  const token_t float_token = { float_text, (uint8_t)(sizeof(float_text) - 1) };
+
+  print_parser(F("parseInt() vs atol()"), 
+    time_parser([&]() { int32_t v; parseInt(int_token, v); int_sink = v; }), 
+    time_parser([&]() { int_sink = atol(int_text); }));
+  print_parser(F("parseHex() vs strtoul()"), 
+    time_parser([&]() { uint32_t v; parseHex(hex_token, v); hex_sink = v; }), 
+    time_parser([&]() { hex_sink = strtoul(hex_text, nullptr, 16); }));
+  print_parser(F("parseFixed() vs atof()"), 
+    time_parser([&]() { int32_t v; parseFixed(float_token, 3, v); int_sink = v; }), 
+    time_parser([&]() { float_sink = atof(float_text); }));
+  print_parser(F("parseFloat() vs atof()"), 
+    time_parser([&]() { float v; parseFloat(float_token, v); float_sink = v; }), 
+    time_parser([&]() { float_sink = atof(float_text); }));
+}
+
+// time each line of the response script from its arrival until its response is written
+void benchmark_responses() {
+  // one iteration per line of response_script
+  for (uint8_t line = 0; line < 4U; line++) {
+    ResponseScript.nextLine();
+    ResponseScript.bytesWritten = 0;
+    ResponseScript.writeCalls = 0;
+
+    const uint32_t start = micros();
+    while ((ResponseScript.available() > 0) || ResponseBench.busy()) {
+      ResponseBench.loop();
+    }
+    // the completed line is handled by the call which reads its line ending,
+    // a scan then continues over the following calls until it is no longer busy
+    const uint32_t elapsed = micros() - start;
+
+    Serial.print(F("Response us: "));
+    Serial.print(elapsed);
+    Serial.print(F(", bytes written: "));
+    Serial.print(ResponseScript.bytesWritten);
+    Serial.print(F(", write calls: "));
+    Serial.print(ResponseScript.writeCalls);
+    Serial.print(F(", I2C us: "));
+    Serial.println(ResponseBench.lastTransactionMicros());
+  }
+}
+
+void setup() {
+  // initialize serial console and set baud rate
+  Serial.begin(TERM_BAUD_RATE);
+  while (!Serial) {}
+
+  Wire.begin();
+
+  Bench.onCommand("led", &count_callback);
+  Bench.onCommand("set", &count_callback);
+  Bench.onCommand("nop", &count_callback);
+}
+
+void loop() {
+  Script.linesRead = 0;
+  Script.bytesRead = 0;
+  Script.bytesWritten = 0;
+  callback_count = 0;
+#if TERM_PROFILING
+  Bench.resetProfile();
+#endif
+
+  const uint32_t start = micros();
+  while (Script.linesRead < BENCHMARK_COMMANDS) {
+    if (Script.available() == 0) {
+      Script.nextLine();
+    }
+    Bench.loop();
+  }
+  // process the final line of the run
+  Bench.loop();
+  const uint32_t elapsed = micros() - start;
+
+  Serial.print(F("Lines: "));
+  Serial.print(Script.linesRead);
+  Serial.print(F(", callbacks: "));
+  Serial.print(callback_count);
+  Serial.print(F(", elapsed us: "));
+  Serial.println(elapsed);
+  Serial.print(F("Commands/s: "));
+  Serial.println((float)Script.linesRead * 1.0e6f / (float)elapsed);
+  Serial.print(F("Bytes parsed/s: "));
+  Serial.println((float)Script.bytesRead * 1.0e6f / (float)elapsed);
+  Serial.print(F("Bytes written: "));
+  Serial.println(Script.bytesWritten);
+
+#if TERM_PROFILING
+  const TerminalCommander::TerminalCommanderTypes::profile_t &profile = Bench.profile();
+  print_stage(F("loop()"), profile.loop);
+  print_stage(F("serialCommandProcessor()"), profile.serialCommandProcessor);
+  print_stage(F("runUserCallbacks()"), profile.runUserCallbacks);
+#endif
+
+  benchmark_responses();
+  benchmark_parsers();
+
+  Serial.println();
+  delay(5000);
+}
@@ -0,0 +1,200 @@
+/*
+ * benchmark.cpp - Host benchmark of the Terminal Commander parsing, dispatch and I2C paths
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ *
+ * The host counterpart of the Terminal-Benchmark example, built with
+ * TERM_PROFILING=1. The script is replayed one line per loop() as fast as
+ * the terminal consumes it, user command dispatch is timed for 10 to 256
+ * registered commands, the argument parsers are timed against their libc
+ * counterparts, then the I2C commands are timed against an emulated device
+ * with a bus time of 90 us per byte (100 kHz).
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+namespace {
+  // Number of script lines to replay per benchmark run
+  const uint32_t benchmark_commands = 200000UL;
+
+  // Script replayed by the benchmark, one command per line
+  const char *const benchmark_script[] = {
+    "led on\n",
+    "led off\n",
+    "set 12, 345; -6.78\n",
+    "nop\n",
+    "  set   a long argument list with trailing whitespace    \n",
+    "unknown command\n",
+  };
+
+  // Registered command counts of the dispatch sweep
+  const uint16_t sweep_counts[] = { 10U, 16U, 32U, 50U, 64U, 100U, 128U, 200U, 256U };
+
+  // Number of dispatches per registered command count
+  const uint32_t sweep_commands = 100000UL;
+
+  // Number of conversions per parser
+  const uint32_t parser_conversions = 1000000UL;
+
+  // I2C commands whose end-to-end response time is measured
+  const char *const response_script[] = {
+    "i2c r 50 00 00 00 00\n",
+    "scan\n",
+    "i2c dump 50 00 100\n",
+    "i2c r 50 00 #64\n",
+  };
+
+  uint32_t callback_count = 0U;
+
+  // converted values are stored, so that no conversion is optimized away
+  volatile int32_t int_sink = 0;
+  volatile uint32_t hex_sink = 0U;
+  volatile float float_sink = 0.0f;
+
+  void count_callback(char*, size_t) {
+    callback_count++;
+  }
+
+  void print_stage(const char *name, const profile_stage_t &stage) {
+    printf("  %-24s calls %8u, avg us %8.3f, max us %6u\n", name, (unsigned)stage.calls,
+           stage.calls ? (double)stage.total_us / (double)stage.calls : 0.0, (unsigned)stage.max_us);
+  }
+
+  void benchmark_throughput(void) {
+    Session<> session;
+    session.terminal.onCommand("led", &count_callback);
+    session.terminal.onCommand("set", &count_callback);
+    session.terminal.onCommand("nop", &count_callback);
+    session.send("");
+    session.terminal.resetProfile();
+
+    const size_t script_lines = sizeof(benchmark_script) / sizeof(benchmark_script[0]);
+    uint32_t bytes = 0U;
+    const uint32_t start_us = micros();
+    for (uint32_t k = 0U; k < benchmark_commands; k++) {
+      const char *line = benchmark_script[k % script_lines];
+      session.serial.feed(line);
+      bytes += (uint32_t)strlen(line);
+      session.terminal.loop();
+      session.serial.output.clear();
+    }
+    const double seconds = (double)(micros() - start_us) / 1e6;
+
+    const profile_t &profile = session.terminal.profile();
+    printf("Throughput (%u commands, %u bytes)\n", (unsigned)benchmark_commands, (unsigned)bytes);
+    printf("  commands/s %12.0f\n", (double)profile.commands / seconds);
+    printf("  bytes/s    %12.0f\n", (double)profile.bytes / seconds);
+    print_stage("loop", profile.loop);
+    print_stage("serialCommandProcessor", profile.serialCommandProcessor);
+    print_stage("runUserCallbacks", profile.runUserCallbacks);
+  }
+
+  void benchmark_dispatch(void) {
+    // names are registered in reverse order, so the dispatch index has to sort them
+    static char names[256][8];
+    static std::string lines[256];
+    for (uint16_t k = 0U; k < 256U; k++) {
+      snprintf(names[k], sizeof(names[k]), "cmd%03u", (unsigned)(255U - k));
+      lines[k] = std::string(names[k]) + " 1\n";
+    }
+
+    printf("Dispatch (%u commands per count)\n", (unsigned)sweep_commands);
+    for (const uint16_t count : sweep_counts) {
+      Session<BasicTerminal<64U, 256U, 30U>> session;
+      for (uint16_t k = 0U; k < count; k++) {
+        session.terminal.onCommand(names[k], &count_callback);
+      }
+      session.send("");
+      session.terminal.resetProfile();
+
+      const uint32_t start_us = micros();
+      for (uint32_t k = 0U; k < sweep_commands; k++) {
+        // a stride coprime to every count visits all commands in a scattered order
+        session.serial.feed(lines[(k * 37U) % count]);
+        session.terminal.loop();
+        session.serial.output.clear();
+      }
+      const uint32_t elapsed_us = micros() - start_us;
+
+      const profile_t &profile = session.terminal.profile();
+      printf("  %3u commands: ns/command %8.1f, runUserCallbacks avg us %6.3f, max us %4u\n",
+             (unsigned)count, (double)elapsed_us * 1000.0 / (double)sweep_commands,
+             profile.runUserCallbacks.calls ? 
+               (double)profile.runUserCallbacks.total_us / (double)profile.runUserCallbacks.calls : 0.0,
+             (unsigned)profile.runUserCallbacks.max_us);
+    }
+  }
+
+  // average time of a single conversion in nanoseconds
+  template <typename parse_fn_t>
+  double time_parser(parse_fn_t parse) {
+    const uint32_t start_us = micros();
+    for (uint32_t k = 0U; k < parser_conversions; k++) {
+      parse();
+    }
+    return (double)(micros() - start_us) * 1000.0 / (double)parser_conversions;
+  }
+
+  void print_parser(const char *name, double parser_ns, double libc_ns) {
+    printf("  %-24s ns %8.1f, libc ns %8.1f\n", name, parser_ns, libc_ns);
+  }
+
+  void benchmark_parsers(void) {
+    static const char int_text[] = "-1234567";
+    static const char hex_text[] = "0x1F2E3D";
+    static const char float_text[] = "-6.78125";
+    const token_t int_token = { int_text, (uint8_t)(sizeof(int_text) - 1U) };
+    const token_t hex_token = { hex_text, (uint8_t)(sizeof(hex_text) - 1U) };
+    const token_t float_token = { float_text, (uint8_t)(sizeof(float_text) - 1U) };
+
+    printf("Parsers (%u conversions each)\n", (unsigned)parser_conversions);
+    print_parser("parseInt() vs atol()", 
+      time_parser([&]() { int32_t v; parseInt(int_token, v); int_sink = v; }), 
+      time_parser([&]() { int_sink = (int32_t)atol(int_text); }));
+    print_parser("parseInt() vs strtol()", 
+      time_parser([&]() { int32_t v; parseInt(int_token, v); int_sink = v; }), 
+      time_parser([&]() { int_sink = (int32_t)strtol(int_text, nullptr, 10); }));
+    print_parser("parseHex() vs strtoul()", 
+      time_parser([&]() { uint32_t v; parseHex(hex_token, v); hex_sink = v; }), 
+      time_parser([&]() { hex_sink = (uint32_t)strtoul(hex_text, nullptr, 16); }));
+    print_parser("parseFixed() vs atof()", 
+      time_parser([&]() { int32_t v; parseFixed(float_token, 3U, v); int_sink = v; }), 
+      time_parser([&]() { float_sink = (float)atof(float_text); }));
+    print_parser("parseFloat() vs atof()", 
+      time_parser([&]() { float v; parseFloat(float_token, v); float_sink = v; }), 
+      time_parser([&]() { float_sink = (float)atof(float_text); }));
+  }
+
+  void benchmark_responses(void) {
+    Session<> session;
+    mock::addDevice(0x50);
+    mock::busMicrosPerByte(90U);
+    session.send("");
+
+    printf("I2C response time (90 us/byte)\n");
+    for (const char *line : response_script) {
+      session.serial.writeCalls = 0U;
+      const uint32_t start_us = micros();
+      const size_t output = session.send(line).size();
+      const uint32_t elapsed_us = micros() - start_us;
+      printf("  %-22.*s response us %8u, bus us %8u, write calls %4u, output bytes %5u\n",
+             (int)(strlen(line) - 1U), line, (unsigned)elapsed_us,
+             (unsigned)session.terminal.lastTransactionMicros(), (unsigned)session.serial.writeCalls,
+             (unsigned)output);
+    }
+  }
+}
+
+int main(void) {
+  benchmark_throughput();
+  benchmark_dispatch();
+  benchmark_parsers();
+  benchmark_responses();
+  return (callback_count > 0U) ? 0 : 1;
+}
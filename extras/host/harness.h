@@ -0,0 +1,199 @@
+/*
+ * harness.h - Host test and benchmark harness for Terminal Commander
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ *
+ * Host code may use the standard library, the library under test may not.
+ */
+
+#ifndef TERMINAL_COMMANDER_HARNESS_H
+#define TERMINAL_COMMANDER_HARNESS_H
+
+  #include <string>
+  #include <vector>
+
+  #include "terminal_commander.h"
+
+  /**
+   * @class HostStream "harness.h"
+   * @brief In-memory Stream which replays fed input and records all output
+   */
+  class HostStream : public Stream {
+    public:
+      /** All output written to the stream and not yet taken */
+      std::string output;
+
+      /** Number of write() calls */
+      uint32_t writeCalls = 0U;
+
+      /** Value reported by availableForWrite(), negative for an always ready stream */
+      int writeSpace = -1;
+
+      /** Maximum number of bytes accepted per write() call, 0 for no limit */
+      size_t writeLimit = 0U;
+
+      /** Number of following write() calls which accept nothing after waiting 1 ms */
+      uint32_t rejectWrites = 0U;
+
+      /** Time in microseconds each read() of a byte adds to the emulated clock */
+      uint32_t readMicros = 0U;
+
+      /** Queue input to be read by the terminal */
+      void feed(const std::string &text) {
+        this->input.append(text);
+      }
+
+      /** Get and clear all output written so far */
+      std::string take(void) {
+        std::string text;
+        text.swap(this->output);
+        return text;
+      }
+
+      int available(void) {
+        return (int)(this->input.size() - this->position);
+      }
+
+      int read(void) {
+        if (this->position >= this->input.size()) {
+          return -1;
+        }
+        mock::advanceMicros(this->readMicros);
+        return (int)(uint8_t)this->input[this->position++];
+      }
+
+      int peek(void) {
+        return (this->position < this->input.size()) ? (int)(uint8_t)this->input[this->position] : -1;
+      }
+
+      size_t write(uint8_t data) {
+        return this->write(&data, 1U);
+      }
+
+      size_t write(const uint8_t *data, size_t size) {
+        this->writeCalls++;
+        if (this->rejectWrites > 0U) {
+          this->rejectWrites--;
+          mock::advanceMicros(1000UL);
+          return 0U;
+        }
+        if ((this->writeLimit > 0U) && (size > this->writeLimit)) {
+          size = this->writeLimit;
+        }
+        this->output.append((const char *)data, size);
+        return size;
+      }
+
+      int availableForWrite(void) {
+        return (this->writeSpace < 0) ? 4096 : this->writeSpace;
+      }
+
+    private:
+      std::string input;
+      size_t position = 0U;
+  };
+
+  /**
+   * @class Session "harness.h"
+   * @brief A terminal connected to a HostStream and the emulated Wire bus
+   *
+   * @tparam terminal_t  Terminal or another BasicTerminal
+   */
+  template <typename terminal_t = TerminalCommander::Terminal>
+  class Session {
+    public:
+      HostStream serial;
+      terminal_t terminal;
+
+      Session(const char command_delimiter = TERM_DEFAULT_CMD_DELIMITER) :
+        terminal(&serial, &Wire, command_delimiter) {}
+
+      /**
+       * @brief Feed input and run loop() until it is consumed and the terminal is idle
+       *
+       * @param   string   Input, usually one or more lines
+       * @param   size_t   Maximum number of loop() calls
+       * @returns string   Output written while the input was handled
+       */
+      std::string send(const std::string &input, size_t max_loops = 10000U) {
+        this->serial.feed(input);
+        for (size_t k = 0; (k < max_loops) && ((this->serial.available() > 0) || this->terminal.busy()); k++) {
+          this->terminal.loop();
+        }
+        this->terminal.loop();
+        return this->serial.take();
+      }
+  };
+
+  namespace test {
+    typedef void (test_fn_t)(void);
+
+    struct test_case_t {
+      const char *name;
+      test_fn_t *fn;
+    };
+
+    inline std::vector<test_case_t> &registry(void) {
+      static std::vector<test_case_t> tests;
+      return tests;
+    }
+
+    inline uint32_t &failures(void) {
+      static uint32_t count = 0U;
+      return count;
+    }
+
+    struct Registrar {
+      Registrar(const char *name, test_fn_t *fn) {
+        registry().push_back({ name, fn });
+      }
+    };
+
+    inline bool check(bool condition, const char *expression, const char *file, int line) {
+      if (!condition) {
+        failures()++;
+        printf("%s:%d: check failed: %s\n", file, line, expression);
+      }
+      return condition;
+    }
+
+    inline bool contains(const std::string &text, const std::string &part) {
+      return text.find(part) != std::string::npos;
+    }
+
+    inline size_t count(const std::string &text, const std::string &part) {
+      size_t n = 0U;
+      for (size_t k = text.find(part); k != std::string::npos; k = text.find(part, k + part.size())) {
+        n++;
+      }
+      return n;
+    }
+
+    /** Run every registered test case on a fresh emulated bus, returns the exit code */
+    inline int run(void) {
+      for (const test_case_t &test_case : registry()) {
+        const uint32_t failed = failures();
+        mock::resetTwoWire();
+        test_case.fn();
+        printf("%s %s\n", (failures() == failed) ? "PASS" : "FAIL", test_case.name);
+      }
+      printf("%u checks failed\n", (unsigned)failures());
+      return (failures() == 0U) ? 0 : 1;
+    }
+  }
+
+  #define TEST(name)                                                  \
+    static void name(void);                                           \
+    static const test::Registrar name##_registrar(#name, &name);      \
+    static void name(void)
+
+  #define CHECK(condition)  test::check((condition), #condition, __FILE__, __LINE__)
+
+  #define CHECK_OUTPUT(text, part)                                    \
+    do {                                                              \
+      const std::string output_text = (text);                         \
+      if (!CHECK(test::contains(output_text, (part)))) {              \
+        printf("  output was: \"%s\"\n", output_text.c_str());        \
+      }                                                               \
+    } while (0)
+#endif
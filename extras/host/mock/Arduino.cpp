@@ -0,0 +1,42 @@
+/*
+ * Arduino.cpp - Host stand-in of the Arduino core for Terminal Commander
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ */
+
+#include "Arduino.h"
+
+#include <chrono>
+
+namespace {
+  const std::chrono::steady_clock::time_point clock_start = std::chrono::steady_clock::now();
+
+  // time added by delays and the emulated I2C bus, in microseconds
+  uint64_t virtual_offset_us = 0U;
+}
+
+uint32_t micros(void) {
+  const uint64_t elapsed_us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - clock_start).count();
+  return (uint32_t)(elapsed_us + virtual_offset_us);
+}
+
+uint32_t millis(void) {
+  const uint64_t elapsed_us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - clock_start).count();
+  return (uint32_t)((elapsed_us + virtual_offset_us) / 1000U);
+}
+
+void delay(unsigned long ms) {
+  virtual_offset_us += (uint64_t)ms * 1000U;
+}
+
+void delayMicroseconds(unsigned int us) {
+  virtual_offset_us += us;
+}
+
+namespace mock {
+  void advanceMicros(uint32_t us) {
+    virtual_offset_us += us;
+  }
+}
@@ -0,0 +1,150 @@
+/*
+ * Arduino.h - Host stand-in of the Arduino core for Terminal Commander
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ *
+ * Provides just enough of the Arduino core to build terminal_commander.cpp
+ * with a host compiler: flash access macros, timing, Print and Stream.
+ */
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+  #include <ctype.h>
+  #include <math.h>
+  #include <stddef.h>
+  #include <stdint.h>
+  #include <stdio.h>
+  #include <stdlib.h>
+  #include <string.h>
+
+  // flash is ordinary memory on the host
+  #define PROGMEM
+  #define PSTR(s)             (s)
+  #define F(s)                (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+  #define pgm_read_byte(p)    (*(const uint8_t *)(p))
+  #define pgm_read_word(p)    (*(const uint16_t *)(p))
+  #define pgm_read_dword(p)   (*(const uint32_t *)(p))
+  #define pgm_read_ptr(p)     (*(void *const *)(p))
+
+  #define strlen_P            strlen
+  #define strcmp_P            strcmp
+  #define strncmp_P           strncmp
+  #define memcpy_P            memcpy
+
+  #define DEC                 (10)
+  #define HEX                 (16)
+
+  class __FlashStringHelper;
+
+  /** @brief Microseconds since start, including all virtual delays */
+  uint32_t micros(void);
+
+  /** @brief Milliseconds since start, including all virtual delays */
+  uint32_t millis(void);
+
+  /** @brief Advance the virtual clock, the host does not sleep */
+  void delay(unsigned long ms);
+
+  /** @brief Advance the virtual clock, the host does not sleep */
+  void delayMicroseconds(unsigned int us);
+
+  namespace mock {
+    /**
+     * @brief Advance micros() and millis() without sleeping
+     *
+     * @details The host clock is the real elapsed time plus a virtual offset.
+     *          delay(), delayMicroseconds() and the emulated I2C bus add to the
+     *          offset, so waits show up in micros() without slowing down a test.
+     *
+     * @param   uint32_t  Microseconds to add to the virtual offset
+     * @returns void
+     */
+    void advanceMicros(uint32_t us);
+  }
+
+  /**
+   * @class Print "Arduino.h"
+   * @brief Arduino Print with the overloads used by Terminal Commander
+   */
+  class Print {
+    public:
+      virtual ~Print(void) {}
+
+      virtual size_t write(uint8_t data) = 0;
+
+      virtual size_t write(const uint8_t *data, size_t size) {
+        size_t n = 0U;
+        while (size-- > 0U) {
+          n += this->write(*data++);
+        }
+        return n;
+      }
+
+      size_t write(const char *str) {
+        return (str == nullptr) ? 0U : this->write((const uint8_t *)str, strlen(str));
+      }
+
+      size_t write(const char *data, size_t size) {
+        return this->write((const uint8_t *)data, size);
+      }
+
+      virtual int availableForWrite(void) { return 0; }
+
+      virtual void flush(void) {}
+
+      size_t print(const __FlashStringHelper *str) { return this->write((const char *)str); }
+      size_t print(const char *str) { return this->write(str); }
+      size_t print(char c) { return this->write((uint8_t)c); }
+      size_t print(unsigned char n, int base = DEC) { return this->printNumber((unsigned long)n, base); }
+      size_t print(int n, int base = DEC) { return this->print((long)n, base); }
+      size_t print(unsigned int n, int base = DEC) { return this->printNumber((unsigned long)n, base); }
+      size_t print(unsigned long n, int base = DEC) { return this->printNumber(n, base); }
+
+      size_t print(long n, int base = DEC) {
+        if ((base == DEC) && (n < 0)) {
+          return this->print('-') + this->printNumber(0UL - (unsigned long)n, base);
+        }
+        return this->printNumber((unsigned long)n, base);
+      }
+
+      size_t print(double n, int digits = 2) {
+        char text[48];
+        snprintf(text, sizeof(text), "%.*f", digits, n);
+        return this->write(text);
+      }
+
+      size_t println(void) { return this->write((const uint8_t *)"\r\n", 2U); }
+
+      template <typename value_t>
+      size_t println(value_t value) { return this->print(value) + this->println(); }
+
+      template <typename value_t>
+      size_t println(value_t value, int format) { return this->print(value, format) + this->println(); }
+
+    private:
+      size_t printNumber(unsigned long n, int base) {
+        char text[sizeof(unsigned long) * 8U + 1U];
+        char *p = &text[sizeof(text) - 1U];
+        *p = '\0';
+        do {
+          const unsigned long digit = n % (unsigned long)base;
+          *--p = (char)((digit < 10U) ? ('0' + digit) : ('A' + digit - 10U));
+          n /= (unsigned long)base;
+        } while (n > 0U);
+        return this->write(p);
+      }
+  };
+
+  /**
+   * @class Stream "Arduino.h"
+   * @brief Arduino Stream, a Print which can also be read
+   */
+  class Stream : public Print {
+    public:
+      virtual int available(void) = 0;
+      virtual int read(void) = 0;
+      virtual int peek(void) = 0;
+  };
+#endif
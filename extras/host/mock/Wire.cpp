@@ -0,0 +1,226 @@
+/*
+ * Wire.cpp - Host stand-in of the Arduino Wire library for Terminal Commander
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ */
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+namespace {
+  // twi_error_type_t codes returned by endTransmission()
+  enum : uint8_t {
+    WireSuccess = 0U,
+    WireTxBufferOverflow = 1U,
+    WireNackAddress = 2U,
+    WireTimeout = 5U,
+  };
+
+  // register file of an emulated device, reads and writes auto-increment the pointer
+  struct device_t {
+    bool present;
+    uint8_t pointer;
+    uint8_t registers[256];
+    uint8_t readLimit;
+    uint8_t failError;
+    uint16_t failCount;
+  };
+
+  device_t devices[128];
+  mock::twowire_stats_t stats[128];
+  uint32_t bus_us_per_byte = 0U;
+  uint32_t wire_timeout_us = 0U;
+  bool wire_timeout_reset = false;
+  bool wire_timeout_flag = false;
+
+  device_t &device(uint8_t address) {
+    return devices[address & 0x7FU];
+  }
+
+  void busTime(uint32_t bytes) {
+    mock::advanceMicros(bytes * bus_us_per_byte);
+  }
+}
+
+void TwoWire::begin(void) {}
+
+void TwoWire::setClock(uint32_t) {}
+
+void TwoWire::setWireTimeout(uint32_t timeout, bool reset_with_timeout) {
+  wire_timeout_us = timeout;
+  wire_timeout_reset = reset_with_timeout;
+}
+
+bool TwoWire::getWireTimeoutFlag(void) {
+  return wire_timeout_flag;
+}
+
+void TwoWire::clearWireTimeoutFlag(void) {
+  wire_timeout_flag = false;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  this->txAddress = address;
+  this->txLength = 0U;
+  this->isTxOverflow = false;
+}
+
+uint8_t TwoWire::endTransmission(void) {
+  return this->endTransmission((uint8_t)true);
+}
+
+uint8_t TwoWire::endTransmission(uint8_t send_stop) {
+  device_t &target = device(this->txAddress);
+  mock::twowire_stats_t &target_stats = stats[this->txAddress & 0x7FU];
+  target_stats.transmissions++;
+  target_stats.timeoutMicros = wire_timeout_us;
+  if (send_stop == 0U) {
+    target_stats.repeatedStarts++;
+  }
+
+  if (this->isTxOverflow) {
+    return WireTxBufferOverflow;
+  }
+  if (target.failCount > 0U) {
+    target.failCount--;
+    busTime(1U);
+    wire_timeout_flag = wire_timeout_flag || (target.failError == WireTimeout);
+    return target.failError;
+  }
+  if (!target.present) {
+    busTime(1U);
+    return WireNackAddress;
+  }
+
+  busTime(1U + this->txLength);
+  target_stats.bytesWritten += this->txLength;
+  if (this->txLength > 0U) {
+    target.pointer = this->txBuffer[0];
+    for (uint8_t k = 1U; k < this->txLength; k++) {
+      target.registers[target.pointer++] = this->txBuffer[k];
+    }
+  }
+  return WireSuccess;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+  return this->requestFrom(address, quantity, (uint8_t)true);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t) {
+  device_t &target = device(address);
+  stats[address & 0x7FU].requests++;
+  this->rxLength = 0U;
+  this->rxIndex = 0U;
+  if (!target.present) {
+    busTime(1U);
+    return 0U;
+  }
+
+  if (quantity > BUFFER_LENGTH) {
+    quantity = BUFFER_LENGTH;
+  }
+  if ((target.readLimit > 0U) && (quantity > target.readLimit)) {
+    quantity = target.readLimit;
+  }
+  for (uint8_t k = 0U; k < quantity; k++) {
+    this->rxBuffer[k] = target.registers[target.pointer++];
+  }
+  this->rxLength = quantity;
+  stats[address & 0x7FU].bytesRead += quantity;
+  busTime(1U + quantity);
+  return quantity;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (this->txLength >= BUFFER_LENGTH) {
+    this->isTxOverflow = true;
+    return 0U;
+  }
+  this->txBuffer[this->txLength++] = data;
+  return 1U;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size) {
+  size_t n = 0U;
+  while ((n < size) && (this->write(data[n]) == 1U)) {
+    n++;
+  }
+  return n;
+}
+
+int TwoWire::available(void) {
+  return (int)(this->rxLength - this->rxIndex);
+}
+
+int TwoWire::read(void) {
+  return (this->rxIndex < this->rxLength) ? (int)this->rxBuffer[this->rxIndex++] : -1;
+}
+
+int TwoWire::peek(void) {
+  return (this->rxIndex < this->rxLength) ? (int)this->rxBuffer[this->rxIndex] : -1;
+}
+
+namespace mock {
+  void resetTwoWire(void) {
+    memset(devices, 0, sizeof(devices));
+    memset(stats, 0, sizeof(stats));
+    bus_us_per_byte = 0U;
+    wire_timeout_us = 0U;
+    wire_timeout_reset = false;
+    wire_timeout_flag = false;
+  }
+
+  void addDevice(uint8_t address) {
+    device_t &target = device(address);
+    memset(&target, 0, sizeof(target));
+    target.present = true;
+  }
+
+  void removeDevice(uint8_t address) {
+    device(address).present = false;
+  }
+
+  uint8_t *deviceRegisters(uint8_t address) {
+    device_t &target = device(address);
+    return target.present ? target.registers : nullptr;
+  }
+
+  void failTransmissions(uint8_t address, uint8_t error, uint16_t count) {
+    device(address).failError = error;
+    device(address).failCount = count;
+  }
+
+  void limitReads(uint8_t address, uint8_t max_bytes) {
+    device(address).readLimit = max_bytes;
+  }
+
+  void busMicrosPerByte(uint32_t us) {
+    bus_us_per_byte = us;
+  }
+
+  const twowire_stats_t &twowireStats(uint8_t address) {
+    return stats[address & 0x7FU];
+  }
+
+  twowire_stats_t twowireTotals(void) {
+    twowire_stats_t totals = {};
+    for (uint8_t k = 0U; k < 128U; k++) {
+      totals.transmissions += stats[k].transmissions;
+      totals.repeatedStarts += stats[k].repeatedStarts;
+      totals.requests += stats[k].requests;
+      totals.bytesWritten += stats[k].bytesWritten;
+      totals.bytesRead += stats[k].bytesRead;
+    }
+    return totals;
+  }
+
+  uint32_t wireTimeout(void) {
+    return wire_timeout_us;
+  }
+
+  bool wireTimeoutReset(void) {
+    return wire_timeout_reset;
+  }
+}
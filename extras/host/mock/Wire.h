@@ -0,0 +1,101 @@
+/*
+ * Wire.h - Host stand-in of the Arduino Wire library for Terminal Commander
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ *
+ * TwoWire has the interface of the AVR core's Wire library, including
+ * setWireTimeout(), and talks to emulated register-file devices instead
+ * of a bus. The emulation is set up and inspected through namespace mock.
+ */
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+  #include "Arduino.h"
+
+  #define WIRE_HAS_TIMEOUT
+
+  // the AVR core's transmit and receive buffer size
+  #define BUFFER_LENGTH   (32U)
+
+  /**
+   * @class TwoWire "Wire.h"
+   * @brief Arduino TwoWire backed by the emulated devices of namespace mock
+   */
+  class TwoWire : public Stream {
+    public:
+      void begin(void);
+      void setClock(uint32_t clock);
+      void setWireTimeout(uint32_t timeout = 25000UL, bool reset_with_timeout = false);
+      bool getWireTimeoutFlag(void);
+      void clearWireTimeoutFlag(void);
+
+      void beginTransmission(uint8_t address);
+      uint8_t endTransmission(void);
+      uint8_t endTransmission(uint8_t send_stop);
+      uint8_t requestFrom(uint8_t address, uint8_t quantity);
+      uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t send_stop);
+
+      size_t write(uint8_t data);
+      size_t write(const uint8_t *data, size_t size);
+      int available(void);
+      int read(void);
+      int peek(void);
+
+    private:
+      uint8_t txAddress = 0U;
+      uint8_t txBuffer[BUFFER_LENGTH] = {0};
+      uint8_t txLength = 0U;
+      bool isTxOverflow = false;
+      uint8_t rxBuffer[BUFFER_LENGTH] = {0};
+      uint8_t rxLength = 0U;
+      uint8_t rxIndex = 0U;
+  };
+
+  extern TwoWire Wire;
+
+  namespace mock {
+    /** @brief Bus activity of a single emulated address */
+    struct twowire_stats_t {
+      uint32_t transmissions;   // endTransmission() calls, including failed ones
+      uint32_t repeatedStarts;  // endTransmission() calls without a STOP
+      uint32_t requests;        // requestFrom() calls
+      uint32_t bytesWritten;    // bytes written after the address, including the register
+      uint32_t bytesRead;       // bytes returned by requestFrom()
+      uint32_t timeoutMicros;   // Wire timeout of the last endTransmission(), not totalled
+    };
+
+    /** @brief Remove all devices, faults and statistics and restore the Wire defaults */
+    void resetTwoWire(void);
+
+    /** @brief Attach a device with 256 zeroed registers at the address */
+    void addDevice(uint8_t address);
+
+    /** @brief Detach the device at the address, it then NACKs its address */
+    void removeDevice(uint8_t address);
+
+    /** @brief Get the 256 registers of the device at the address, nullptr if absent */
+    uint8_t *deviceRegisters(uint8_t address);
+
+    /** @brief Fail the next count transmissions to the address with the twi_error_type_t code */
+    void failTransmissions(uint8_t address, uint8_t error, uint16_t count = 1U);
+
+    /** @brief Return at most max_bytes bytes per requestFrom() from the address */
+    void limitReads(uint8_t address, uint8_t max_bytes);
+
+    /** @brief Bus time added to micros() per byte on the bus, including the address byte */
+    void busMicrosPerByte(uint32_t us);
+
+    /** @brief Get the bus activity of an address since resetTwoWire() */
+    const twowire_stats_t &twowireStats(uint8_t address);
+
+    /** @brief Get the bus activity summed over all addresses since resetTwoWire() */
+    twowire_stats_t twowireTotals(void);
+
+    /** @brief Get the timeout last set with setWireTimeout(), 0 if disabled */
+    uint32_t wireTimeout(void);
+
+    /** @brief Get the reset_with_timeout flag last set with setWireTimeout() */
+    bool wireTimeoutReset(void);
+  }
+#endif
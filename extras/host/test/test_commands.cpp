@@ -0,0 +1,297 @@
+/*
+ * test_commands.cpp - User command dispatch and argument parsing regression tests
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ */
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+namespace {
+  std::string last_command;
+  std::vector<std::string> last_argv;
+  std::vector<arg_value_t> last_values;
+
+  void reset_record(void) {
+    last_command.clear();
+    last_argv.clear();
+    last_values.clear();
+  }
+
+  void alpha(char*, size_t) { last_command = "alpha"; }
+  void beta(char*, size_t) { last_command = "beta"; }
+  void beta_again(char*, size_t) { last_command = "beta again"; }
+  void gamma(char*, size_t) { last_command = "gamma"; }
+  void led(char*, size_t) { last_command = "led"; }
+  void list(char*, size_t) { last_command = "list"; }
+
+  void record_argv(const token_t *argv, uint8_t argc) {
+    last_command = "argv";
+    last_argv.clear();
+    for (uint8_t k = 0U; k < argc; k++) {
+      last_argv.push_back(std::string(argv[k].ptr, argv[k].len));
+    }
+  }
+
+  void record_values(const arg_value_t *values, uint8_t count) {
+    last_command = "args";
+    last_values.assign(values, values + count);
+  }
+
+  token_t token(const char *text) {
+    return { text, (uint8_t)strlen(text) };
+  }
+
+  // a command slot holds its name, callback and schema by pointer only
+  static_assert(sizeof(user_callback_char_t) <= (4U * sizeof(void*)), "command slots hold no compiled schema");
+
+  static constexpr user_callback_P_t table_commands[] PROGMEM = {
+    { "gamma", &gamma, nullptr, "", nullptr },
+    { "split", nullptr, &record_argv, "", nullptr },
+    { "typed", nullptr, nullptr, "u8 hex", &record_values },
+  };
+  static_assert(isCommandTableSorted(table_commands), "unsorted commands");
+
+  static constexpr user_callback_P_t bad_schema_commands[] PROGMEM = {
+    { "bad", nullptr, nullptr, "u8 u12", &record_values },
+  };
+
+  static constexpr user_callback_P_t unsorted_commands[] PROGMEM = {
+    { "beta", &beta, nullptr, "", nullptr },
+    { "alpha", &alpha, nullptr, "", nullptr },
+    { "gamma", &gamma, nullptr, "", nullptr },
+  };
+  static_assert(!isCommandTableSorted(unsorted_commands), "unsorted commands are detected");
+
+  static constexpr user_callback_P_t repeated_commands[] PROGMEM = {
+    { "alpha", &alpha, nullptr, "", nullptr },
+    { "alpha", &beta, nullptr, "", nullptr },
+  };
+}
+
+TEST(commands_dispatch_in_any_registration_order) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("gamma", &gamma);
+  session.terminal.onCommand("beta", &beta);
+  session.terminal.onCommand("alpha", &alpha);
+
+  session.send("alpha\n");
+  CHECK(last_command == "alpha");
+  session.send("beta\n");
+  CHECK(last_command == "beta");
+  session.send("gamma\n");
+  CHECK(last_command == "gamma");
+  CHECK_OUTPUT(session.send("delta\n"), "Error: Unrecognized Protocol\n");
+  CHECK_OUTPUT(session.send("bet\n"), "Error: Unrecognized Protocol\n");
+}
+
+TEST(first_registration_of_a_command_wins) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("beta", &beta);
+  session.terminal.onCommand("beta", &beta_again);
+
+  session.send("beta\n");
+  CHECK(last_command == "beta");
+}
+
+TEST(commands_beyond_the_capacity_are_ignored) {
+  Session<BasicTerminal<64U, 2U, 30U>> session;
+  reset_record();
+  session.terminal.onCommand("alpha", &alpha);
+  session.terminal.onCommand("beta", &beta);
+  session.terminal.onCommand("gamma", &gamma);
+
+  session.send("beta\n");
+  CHECK(last_command == "beta");
+  CHECK_OUTPUT(session.send("gamma\n"), "Error: Unrecognized Protocol\n");
+}
+
+TEST(progmem_table_commands_dispatch) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommands(table_commands);
+
+  session.send("gamma\n");
+  CHECK(last_command == "gamma");
+  session.send("split a b\n");
+  CHECK((last_argv.size() == 2U) && (last_argv[1] == "b"));
+  session.send("typed 7 ff\n");
+  CHECK((last_values.size() == 2U) && (last_values[0].u == 7U) && (last_values[1].u == 0xFFU));
+}
+
+TEST(registered_commands_overload_the_progmem_table) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommands(table_commands);
+  session.terminal.onCommand("gamma", &alpha);
+
+  session.send("gamma\n");
+  CHECK(last_command == "alpha");
+}
+
+TEST(unique_prefixes_resolve_when_abbreviations_are_enabled) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("led", &led);
+  session.terminal.onCommand("list", &list);
+
+  CHECK_OUTPUT(session.send("le\n"), "Error: Unrecognized Protocol\n");
+  session.terminal.abbreviate(true);
+  session.send("le\n");
+  CHECK(last_command == "led");
+  session.send("li\n");
+  CHECK(last_command == "list");
+  CHECK_OUTPUT(session.send("l\n"), "Error: Ambiguous Command\n");
+}
+
+TEST(built_in_commands_can_be_abbreviated) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.terminal.abbreviate(true);
+
+  CHECK_OUTPUT(session.send("sc\n"), "I2C device found at Address: 0x50");
+  CHECK_OUTPUT(session.send("I2 r 50 00\n"), "Read Data: 0x00\n");
+}
+
+TEST(argv_callbacks_receive_tokens) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_argv);
+
+  session.send("set 12, 345;-6.78  x\n");
+  CHECK(last_argv.size() == 4U);
+  CHECK((last_argv.size() == 4U) && (last_argv[0] == "12") && (last_argv[1] == "345") &&
+        (last_argv[2] == "-6.78") && (last_argv[3] == "x"));
+
+  session.send("set\n");
+  CHECK(last_argv.empty());
+
+  reset_record();
+  CHECK_OUTPUT(session.send("set 1 2 3 4 5 6 7 8 9\n"), "Error: Too Many Arguments\n");
+  CHECK(last_command.empty());
+}
+
+TEST(callbacks_can_report_errors) {
+  Session<> session;
+  static TerminalBase<uint8_t> *terminal = nullptr;
+  terminal = &session.terminal;
+  session.terminal.onCommand("check", [](const token_t *argv, uint8_t argc) {
+    int32_t value = 0;
+    if ((argc < 1U) || (parseInt(argv[0], value) != NoError)) {
+      terminal->error(InvalidNumber);
+    }
+  });
+  CHECK_OUTPUT(session.send("check x\n"), "Error: Invalid Number\n");
+  CHECK(!test::contains(session.send("check 5\n"), "Error"));
+}
+
+TEST(integer_parsers) {
+  int32_t i = 0;
+  uint32_t u = 0U;
+  CHECK((parseInt(token("-2147483648"), i) == NoError) && (i == INT32_MIN));
+  CHECK(parseInt(token("2147483648"), i) == NumberOutOfRange);
+  CHECK(parseInt(token("-"), i) == InvalidNumber);
+  CHECK(parseInt(token("12a"), i) == InvalidNumber);
+  CHECK((parseUInt(token("4294967295"), u) == NoError) && (u == UINT32_MAX));
+  CHECK(parseUInt(token("4294967296"), u) == NumberOutOfRange);
+  CHECK(parseUInt(token("-1"), u) == InvalidNumber);
+  CHECK((parseHex(token("0x1F2e"), u) == NoError) && (u == 0x1F2EU));
+  CHECK((parseHex(token("ffffffff"), u) == NoError) && (u == 0xFFFFFFFFU));
+  CHECK(parseHex(token("100000000"), u) == NumberOutOfRange);
+  CHECK(parseHex(token("0x"), u) == InvalidNumber);
+  CHECK(parseHex(token("0g"), u) == InvalidNumber);
+}
+
+TEST(fixed_and_float_parsers) {
+  int32_t i = 0;
+  float f = 0.0f;
+  CHECK((parseFixed(token("-1.25"), 3U, i) == NoError) && (i == -1250));
+  CHECK((parseFixed(token("1.2345"), 3U, i) == NoError) && (i == 1235));
+  CHECK((parseFixed(token(".5"), 1U, i) == NoError) && (i == 5));
+  CHECK(parseFixed(token("3000000"), 3U, i) == NumberOutOfRange);
+  CHECK(parseFixed(token("1.2.3"), 3U, i) == InvalidNumber);
+  CHECK((parseFloat(token("-6.78"), f) == NoError) && (fabsf(f + 6.78f) < 1e-5f));
+  CHECK((parseFloat(token("1.5e-3"), f) == NoError) && (fabsf(f - 1.5e-3f) < 1e-9f));
+  CHECK(parseFloat(token("1e99"), f) == NumberOutOfRange);
+  CHECK(parseFloat(token("e5"), f) == InvalidNumber);
+}
+
+TEST(schema_args_are_converted_before_dispatch) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("pwm", "u8 i16 fix2 float str", &record_values);
+
+  session.send("pwm 255 -300 1.25 0.5 on\n");
+  CHECK(last_values.size() == 5U);
+  CHECK((last_values.size() == 5U) && (last_values[0].u == 255U) && (last_values[1].i == -300) &&
+        (last_values[2].i == 125) && (last_values[3].f == 0.5f) && (last_values[4].s.len == 2U));
+}
+
+TEST(schema_errors_never_reach_the_callback) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("pwm", "u8 u16", &record_values);
+
+  CHECK_OUTPUT(session.send("pwm 256 1\n"), "Error: Number Out of Range at char 5\n");
+  CHECK_OUTPUT(session.send("pwm 1 x\n"), "Error: Invalid Number at char 7\n");
+  CHECK_OUTPUT(session.send("pwm 1\n"), "Error: Missing Argument\n");
+  CHECK_OUTPUT(session.send("pwm 1 2 3\n"), "Error: Too Many Arguments at char 9\n");
+  CHECK(last_command.empty());
+}
+
+TEST(schema_optional_and_repeated_args) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("opt", "u8 u8?", &record_values);
+  session.terminal.onCommand("rep", "u8 hex*", &record_values);
+
+  session.send("opt 1\n");
+  CHECK(last_values.size() == 1U);
+  session.send("opt 1 2\n");
+  CHECK(last_values.size() == 2U);
+  session.send("rep 1\n");
+  CHECK(last_values.size() == 1U);
+  session.send("rep 1 a b c\n");
+  CHECK((last_values.size() == 4U) && (last_values[3].u == 0x0CU));
+}
+
+TEST(invalid_schemas_are_rejected_at_registration) {
+  Session<> session;
+  reset_record();
+
+  CHECK(!session.terminal.onCommand("a", "u12", &record_values));
+  CHECK(!session.terminal.onCommand("b", "int", &record_values));
+  CHECK(!session.terminal.onCommand("c", "u8? u8", &record_values));
+  CHECK(!session.terminal.onCommand("d", "u8* u8", &record_values));
+  CHECK(!session.terminal.onCommand("e", "u8 u8 u8 u8 u8 u8 u8 u8 u8", &record_values));
+  CHECK(session.terminal.onCommand("f", "u8 u8 u8 u8 u8 u8 u8 u8", &record_values));
+  CHECK(session.terminal.onCommand("g", "", &record_values));
+
+  CHECK_OUTPUT(session.send("a 1\n"), "Error: Unrecognized Protocol\n");
+  CHECK_OUTPUT(session.send("g 1\n"), "Error: Too Many Arguments at char 3\n");
+  session.send("g\n");
+  CHECK((last_command == "args") && last_values.empty());
+
+  CHECK(!session.terminal.onCommands(bad_schema_commands));
+  CHECK_OUTPUT(session.send("bad 1 2\n"), "Error: Unrecognized Protocol\n");
+  CHECK(session.terminal.onCommands(table_commands));
+}
+
+TEST(unsorted_tables_are_rejected) {
+  Session<> session;
+  reset_record();
+
+  CHECK(!session.terminal.onCommands(unsorted_commands));
+  CHECK_OUTPUT(session.send("gamma\n"), "Error: Unrecognized Protocol\n");
+  CHECK(!session.terminal.onCommands(repeated_commands));
+  CHECK_OUTPUT(session.send("alpha\n"), "Error: Unrecognized Protocol\n");
+  CHECK(last_command.empty());
+}
+
+int main(void) {
+  return test::run();
+}
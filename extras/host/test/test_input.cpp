@@ -0,0 +1,190 @@
+/*
+ * test_input.cpp - Terminal input, lexing and loop() regression tests
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ */
+
+#include <algorithm>
+#include <type_traits>
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+namespace {
+  std::string last_args;
+  uint32_t calls = 0U;
+
+  void record_args(char *args, size_t size) {
+    last_args = (args != nullptr) ? std::string(args, size) : std::string("<null>");
+    calls++;
+  }
+
+  void reset_record(void) {
+    last_args.clear();
+    calls = 0U;
+  }
+}
+
+TEST(prompt_is_printed_once_idle) {
+  Session<> session;
+  CHECK(session.send("") == ">> ");
+  CHECK(session.send("") == "");
+}
+
+TEST(user_args_are_trimmed_in_place) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  session.send("  set   12  34   \n");
+  CHECK(last_args == "12  34");
+  session.send("set\n");
+  CHECK(last_args == "<null>");
+  CHECK(calls == 2U);
+}
+
+TEST(empty_line_reports_no_input) {
+  Session<> session;
+  CHECK_OUTPUT(session.send("   \n"), "Error: No Input\n");
+}
+
+TEST(invalid_character_reports_its_position) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  CHECK_OUTPUT(session.send("set 1$2\n"), "Error: Unrecognized Input Character at char 6\n");
+  CHECK_OUTPUT(session.send("set \x01\n"), "Error: Unrecognized Input Character at char 5\n");
+  CHECK(calls == 0U);
+}
+
+TEST(symbols_and_separators_are_valid_args) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  session.send("set -1.5, #2; x\n");
+  CHECK(last_args == "-1.5, #2; x");
+}
+
+TEST(custom_command_delimiter) {
+  Session<> session(',');
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  session.send("set,1 2\n");
+  CHECK(last_args == "1 2");
+}
+
+TEST(overlong_line_is_discarded_up_to_its_line_ending) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  const std::string output = session.send(std::string(100U, 'a') + "\nset 1\n");
+  CHECK(test::count(output, "Error: Serial Command Length Exceeds Limit") == 1U);
+  CHECK(last_args == "1");
+  CHECK(calls == 1U);
+}
+
+TEST(flood_without_line_ending_is_bounded_and_reported_once) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+  session.send("");
+
+  // 64 kB of input which never ends its line, read within a loop() budget while
+  // each byte takes 10 us of emulated time, so that the bound doesn't depend on
+  // the speed or load of the host
+  const uint32_t budget_us = 500UL;
+  session.serial.readMicros = 10U;
+  session.serial.feed(std::string(65536U, 'a'));
+  uint32_t loops = 0U;
+  int most_read = 0;
+  while ((session.serial.available() > 0) && (loops < 1000000UL)) {
+    const int available = session.serial.available();
+    session.terminal.loop(budget_us);
+    most_read = std::max(most_read, available - session.serial.available());
+    loops++;
+  }
+  session.serial.readMicros = 0U;
+  CHECK(session.serial.available() == 0);
+  CHECK(session.serial.take().empty());
+
+  // no loop() reads more bytes than fit in its budget
+  CHECK(most_read > 0);
+  CHECK(most_read <= (int)(budget_us / 10UL));
+
+  const std::string output = session.send("\nset 1\n");
+  CHECK(test::count(output, "Error: Serial Command Length Exceeds Limit") == 1U);
+  CHECK(test::count(output, "Error") == 1U);
+  CHECK(last_args == "1");
+  CHECK(calls == 1U);
+}
+
+TEST(input_after_a_line_ending_waits_for_the_next_loop) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  session.serial.feed("set 1\nset 2\n");
+  session.terminal.loop();
+  CHECK(last_args == "1");
+  session.terminal.loop();
+  CHECK(last_args == "2");
+  CHECK(calls == 2U);
+}
+
+TEST(budgeted_loop_handles_every_line_once) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+
+  session.serial.feed("set 1\nset 2\nset 3\n");
+  for (int k = 0; (k < 1000) && ((session.serial.available() > 0) || (calls < 3U)); k++) {
+    session.terminal.loop(1UL);
+  }
+  CHECK(last_args == "3");
+  CHECK(calls == 3U);
+}
+
+TEST(worst_case_loop_duration_is_tracked) {
+  Session<> session;
+  session.send("\n");
+  session.terminal.resetMaxLoopMicros();
+  CHECK(session.terminal.maxLoopMicros() == 0UL);
+
+  session.terminal.onCommand("slow", [](char*, size_t) { delayMicroseconds(5000U); });
+  session.send("slow\n");
+  CHECK(session.terminal.maxLoopMicros() >= 5000UL);
+}
+
+TEST(backspace_removes_the_previous_char) {
+  Session<> session;
+  reset_record();
+  session.terminal.onCommand("set", &record_args);
+  session.terminal.echo(true);
+
+  const std::string output = session.send("sex\bt 5\n");
+  CHECK(last_args == "5");
+  CHECK_OUTPUT(output, "sex\b \bt 5\n");
+}
+
+TEST(wide_terminals_index_with_uint16_t) {
+  typedef BasicTerminal<300U, 4U, 30U> wide_terminal_t;
+  static_assert(std::is_same<wide_terminal_t::index_t, uint16_t>::value, "wide terminal index type");
+  static_assert(std::is_same<Terminal::index_t, uint8_t>::value, "default terminal index type");
+
+  Session<wide_terminal_t> session;
+  reset_record();
+  session.terminal.onCommand("long", &record_args);
+
+  session.send("long " + std::string(275U, 'x') + "\n");
+  CHECK(last_args.size() == 275U);
+}
+
+int main(void) {
+  return test::run();
+}
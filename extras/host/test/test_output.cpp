@@ -0,0 +1,160 @@
+/*
+ * test_output.cpp - Output staging, flush and backpressure regression tests
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ */
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+namespace {
+  // true if every hexdump line of the output is complete
+  bool hasOnlyCompleteDumpLines(const std::string &output) {
+    size_t start = 0U;
+    while (start < output.size()) {
+      size_t end = output.find('\n', start);
+      if (end == std::string::npos) {
+        end = output.size();
+      }
+      const std::string line = output.substr(start, end - start);
+      if ((line.size() > 3U) && (line[2] == ':') && (line.back() != '|')) {
+        return false;
+      }
+      start = end + 1U;
+    }
+    return true;
+  }
+}
+
+TEST(response_is_written_in_one_call) {
+  Session<> session;
+  session.send("");
+  session.serial.writeCalls = 0U;
+
+  CHECK(session.send("\n") == "Error: No Input\n>> ");
+  CHECK(session.serial.writeCalls == 1U);
+}
+
+TEST(flush_per_line_writes_every_line) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.terminal.outputPolicy(FlushPerLine);
+  session.send("");
+  session.serial.writeCalls = 0U;
+
+  session.send("i2c r 50 00\n");
+  CHECK(session.serial.writeCalls >= 4U);
+}
+
+TEST(flush_when_full_holds_output_until_flush) {
+  Session<> session;
+  session.terminal.outputPolicy(FlushWhenFull);
+
+  CHECK(session.send("\n") == "");
+  session.terminal.flush();
+  CHECK(session.serial.take() == "Error: No Input\n>> ");
+}
+
+TEST(tx_block_writes_everything) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.serial.writeSpace = 0;
+
+  const std::string output = session.send("i2c dump 50 00 100\n");
+  CHECK(test::count(output, "|\n") == 16U);
+  CHECK(session.terminal.droppedBytes() == 0UL);
+}
+
+TEST(tx_block_retries_short_writes) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.serial.writeLimit = 5U;
+
+  const std::string output = session.send("i2c dump 50 00 100\n");
+  CHECK(test::count(output, "|\n") == 16U);
+  CHECK(session.terminal.droppedBytes() == 0UL);
+
+  session.serial.rejectWrites = 20U;
+  CHECK(test::count(session.send("i2c dump 50 00 100\n"), "|\n") == 16U);
+  CHECK(session.terminal.droppedBytes() == 0UL);
+}
+
+TEST(tx_block_gives_up_on_a_stream_which_accepts_nothing) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.send("");
+  session.serial.rejectWrites = UINT32_MAX;
+
+  session.send("i2c dump 50 00 100\n");
+  CHECK(session.terminal.droppedBytes() > 1000UL);
+
+  // once timed out, output is dropped without retrying until the Stream recovers
+  session.serial.writeCalls = 0U;
+  session.send("\n");
+  CHECK(session.serial.writeCalls < 32U);
+
+  session.serial.rejectWrites = 0U;
+  session.terminal.resetDroppedBytes();
+  CHECK_OUTPUT(session.send("\n"), "Error: No Input\n>> ");
+  CHECK(session.terminal.droppedBytes() == 0UL);
+}
+
+TEST(tx_drop_never_waits_and_counts_dropped_bytes) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.terminal.backpressure(TxDrop);
+  session.serial.writeSpace = 0;
+
+  CHECK(session.send("i2c dump 50 00 100\n") == "");
+  const uint32_t dropped = session.terminal.droppedBytes();
+  CHECK(dropped > 1000UL);
+
+  session.serial.writeSpace = -1;
+  session.terminal.flush();
+  CHECK(session.serial.take().size() == TERM_OUTPUT_BUFFER_SIZE);
+
+  session.terminal.resetDroppedBytes();
+  CHECK(session.terminal.droppedBytes() == 0UL);
+}
+
+TEST(tx_drop_writes_no_more_than_available) {
+  Session<> session;
+  session.terminal.backpressure(TxDrop);
+  session.send("");
+  session.serial.writeSpace = 4;
+
+  session.serial.feed("\n");
+  session.terminal.loop();
+  CHECK(session.serial.take() == "Erro");
+  session.terminal.loop();
+  CHECK(session.serial.take() == "r: N");
+  session.serial.writeSpace = -1;
+  CHECK(session.send("") == "o Input\n>> ");
+}
+
+TEST(tx_truncate_keeps_lines_intact) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.terminal.backpressure(TxTruncate);
+  session.serial.writeSpace = 0;
+
+  session.send("i2c dump 50 00 100\n");
+  CHECK(session.terminal.droppedBytes() > 0UL);
+  session.serial.writeSpace = -1;
+  session.terminal.flush();
+
+  // the staged start of the cut line is written, its line ending is still owed
+  const std::string cut = session.serial.take();
+  CHECK(cut.size() == TERM_OUTPUT_BUFFER_SIZE);
+  CHECK(!hasOnlyCompleteDumpLines(cut));
+
+  // the prompt line was being cut, so the response following it on the same line is dropped
+  CHECK(session.send("\n") == "\n>> ");
+  CHECK(session.send("\n") == "Error: No Input\n>> ");
+}
+
+int main(void) {
+  return test::run();
+}
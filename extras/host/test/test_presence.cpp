@@ -0,0 +1,83 @@
+/*
+ * test_presence.cpp - I2C device presence cache regression tests
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ *
+ * Built with TERM_TWOWIRE_PRESENCE_MS=5000.
+ */
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+TEST(absent_addresses_fail_fast_within_the_presence_window) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.send("scan\n");
+  const uint32_t transmissions = mock::twowireStats(0x33).transmissions;
+
+  CHECK_OUTPUT(session.send("i2c r 33 00\n"), "Error: I2C device not present at address 0x33\n");
+  CHECK(mock::twowireStats(0x33).transmissions == transmissions);
+  CHECK_OUTPUT(session.send("i2c r 50 00\n"), "Read Data: 0x00\n");
+
+  mock::advanceMicros((TERM_TWOWIRE_PRESENCE_MS + 1UL) * 1000UL);
+  CHECK_OUTPUT(session.send("i2c r 33 00\n"), "Error: I2C address recieved NACK at address 0x33\n");
+  CHECK(mock::twowireStats(0x33).transmissions > transmissions);
+
+  session.terminal.presenceWindow(0UL);
+  CHECK_OUTPUT(session.send("i2c r 33 00\n"), "Error: I2C address recieved NACK at address 0x33\n");
+}
+
+TEST(delta_scan_only_reports_changes) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.send("scan\n");
+
+  const uint32_t transmissions = mock::twowireTotals().transmissions;
+  CHECK_OUTPUT(session.send("scan --delta\n"), "Scan complete, 0 devices changed\r\n");
+  CHECK(mock::twowireTotals().transmissions == transmissions);
+
+  mock::addDevice(0x40);
+  mock::removeDevice(0x50);
+  mock::advanceMicros((TERM_TWOWIRE_PRESENCE_MS + 1UL) * 1000UL);
+  const std::string output = session.send("scan --delta\n");
+  CHECK_OUTPUT(output, "I2C device appeared at Address: 0x40\r\n");
+  CHECK_OUTPUT(output, "I2C device disappeared at Address: 0x50\r\n");
+  CHECK_OUTPUT(output, "Scan complete, 2 devices changed\r\n");
+}
+
+TEST(read_and_write_nacks_never_mark_an_address_absent) {
+  Session<> session;
+  mock::addDevice(0x50);
+
+  // an address which wasn't scanned is tried every time
+  const uint8_t value = 0x01;
+  CHECK(session.terminal.i2cWrite(0x33, 0x00, &value, 1U) == NACK_ADDRESS);
+  CHECK(session.terminal.i2cWrite(0x33, 0x00, &value, 1U) == NACK_ADDRESS);
+  CHECK(mock::twowireStats(0x33).transmissions == 2U);
+
+  // e.g. an EEPROM which doesn't ACK during its write cycle
+  session.send("scan\n");
+  mock::failTransmissions(0x50, NACK_ADDRESS);
+  CHECK_OUTPUT(session.send("i2c r 50 00\n"), "Error: I2C address recieved NACK at address 0x50\n");
+  CHECK_OUTPUT(session.send("i2c r 50 00\n"), "Read Data: 0x00\n");
+}
+
+TEST(reads_dont_restart_the_window_of_a_row) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.send("scan\n");
+
+  // a read of 0x50 doesn't extend the absence of 0x51, recorded by the scan
+  mock::advanceMicros((TERM_TWOWIRE_PRESENCE_MS - 1000UL) * 1000UL);
+  CHECK_OUTPUT(session.send("i2c r 50 00\n"), "Read Data: 0x00\n");
+  CHECK_OUTPUT(session.send("i2c r 51 00\n"), "Error: I2C device not present at address 0x51\n");
+  mock::advanceMicros(2000UL * 1000UL);
+  CHECK_OUTPUT(session.send("i2c r 50 00\n"), "Read Data: 0x00\n");
+  CHECK_OUTPUT(session.send("i2c r 51 00\n"), "Error: I2C address recieved NACK at address 0x51\n");
+}
+
+int main(void) {
+  return test::run();
+}
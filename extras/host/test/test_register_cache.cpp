@@ -0,0 +1,202 @@
+/*
+ * test_register_cache.cpp - I2C register shadow cache regression tests
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ *
+ * Built with TERM_REGISTER_CACHE_SIZE=16.
+ */
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+TEST(capacity_is_checked_on_declaration) {
+  Session<> session;
+
+  CHECK(session.terminal.cacheRegisters(0x50, 0x00, 12U));
+  CHECK(!session.terminal.cacheRegisters(0x51, 0x00, 5U));
+  CHECK(session.terminal.cacheRegisters(0x50, 0x08, 8U));
+  CHECK(!session.terminal.cacheRegisters(0x50, 0xF8, 9U));
+  session.terminal.uncacheRegisters(0x50, 0x00, 4U);
+  CHECK(session.terminal.cacheRegisters(0x51, 0x00, 4U));
+}
+
+TEST(reads_are_served_from_the_cache_once_filled) {
+  Session<> session;
+  mock::addDevice(0x50);
+  memcpy(&mock::deviceRegisters(0x50)[0x10], "\x01\x02\x03\x04", 4U);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x10, 4U));
+
+  uint8_t data[4] = {0};
+  CHECK(session.terminal.i2cRead(0x50, 0x10, data, 4U) == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).requests == 1U);
+  CHECK(session.terminal.registerCacheMisses() == 4UL);
+
+  memset(data, 0, sizeof(data));
+  CHECK(session.terminal.i2cRead(0x50, 0x10, data, 4U) == NO_ERROR);
+  CHECK(memcmp(data, "\x01\x02\x03\x04", 4U) == 0);
+  CHECK_OUTPUT(session.send("i2c r 50 11 00\n"), "Read Data: 0x02 0x03\n");
+  CHECK(mock::twowireStats(0x50).requests == 1U);
+  CHECK(session.terminal.registerCacheHits() == 6UL);
+
+  session.terminal.resetRegisterCacheCounters();
+  CHECK((session.terminal.registerCacheHits() == 0UL) && (session.terminal.registerCacheMisses() == 0UL));
+}
+
+TEST(only_registers_without_a_value_are_read) {
+  Session<> session;
+  mock::addDevice(0x50);
+  for (uint16_t k = 0U; k < 0x20U; k++) {
+    mock::deviceRegisters(0x50)[k] = (uint8_t)(0xA0U + k);
+  }
+  CHECK(session.terminal.cacheRegisters(0x50, 0x04, 4U));
+  CHECK(session.terminal.cacheRegisters(0x50, 0x0C, 2U));
+  uint8_t data[16];
+  session.terminal.i2cRead(0x50, 0x04, data, 4U);
+  session.terminal.i2cRead(0x50, 0x0C, data, 2U);
+  session.terminal.invalidateRegisters(0x50, 0x06, 1U);
+  session.terminal.resetRegisterCacheCounters();
+  const uint32_t requests = mock::twowireStats(0x50).requests;
+  const uint32_t bytes_read = mock::twowireStats(0x50).bytesRead;
+
+  // 0x00-0x03, 0x06 and 0x08-0x0B are read in three transactions
+  memset(data, 0, sizeof(data));
+  CHECK(session.terminal.i2cRead(0x50, 0x00, data, 14U) == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).requests == (requests + 3U));
+  CHECK(mock::twowireStats(0x50).bytesRead == (bytes_read + 9U));
+  bool isMatching = true;
+  for (uint8_t k = 0U; k < 14U; k++) {
+    isMatching = isMatching && (data[k] == (uint8_t)(0xA0U + k));
+  }
+  CHECK(isMatching);
+  CHECK(session.terminal.registerCacheHits() == 5UL);
+  CHECK(session.terminal.registerCacheMisses() == 1UL);
+
+  // a failed run ends the read
+  mock::failTransmissions(0x50, NACK_DATA);
+  CHECK(session.terminal.i2cRead(0x50, 0x00, data, 8U) == NACK_DATA);
+}
+
+TEST(uncached_and_invalidated_registers_read_the_device) {
+  Session<> session;
+  mock::addDevice(0x50);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x10, 4U));
+
+  uint8_t data[4];
+  session.terminal.i2cRead(0x50, 0x10, data, 4U);
+  session.terminal.invalidateRegisters(0x50);
+  session.terminal.i2cRead(0x50, 0x10, data, 4U);
+  CHECK(mock::twowireStats(0x50).requests == 2U);
+
+  session.terminal.uncacheRegisters(0x50, 0x10, 4U);
+  session.terminal.i2cRead(0x50, 0x10, data, 4U);
+  session.terminal.i2cRead(0x50, 0x10, data, 4U);
+  CHECK(mock::twowireStats(0x50).requests == 4U);
+}
+
+TEST(dump_always_reads_the_device) {
+  Session<> session;
+  mock::addDevice(0x50);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x00, 16U));
+  session.send("i2c r 50 00 #16\n");
+  const uint32_t requests = mock::twowireStats(0x50).requests;
+
+  session.send("i2c dump 50 00 10\n");
+  CHECK(mock::twowireStats(0x50).requests == (requests + 1U));
+}
+
+TEST(writes_are_held_back_until_flushed) {
+  Session<> session;
+  mock::addDevice(0x50);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x10, 4U));
+
+  const uint8_t values[3] = { 0xA1, 0xA2, 0xA3 };
+  CHECK(session.terminal.i2cWrite(0x50, 0x11, values, 3U) == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).transmissions == 0U);
+  CHECK(mock::deviceRegisters(0x50)[0x11] == 0x00U);
+
+  // the pending values are newer than the device's
+  uint8_t data[4] = {0};
+  CHECK(session.terminal.i2cRead(0x50, 0x10, data, 4U) == NO_ERROR);
+  CHECK((data[0] == 0x00U) && (data[1] == 0xA1U) && (data[3] == 0xA3U));
+
+  CHECK(session.terminal.flushRegisters() == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).transmissions == 2U);
+  CHECK(memcmp(&mock::deviceRegisters(0x50)[0x11], values, 3U) == 0);
+  CHECK(session.terminal.flushRegisters() == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).transmissions == 2U);
+}
+
+TEST(failed_flushes_keep_registers_dirty) {
+  Session<> session;
+  mock::addDevice(0x50);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x10, 2U));
+
+  const uint8_t values[2] = { 0x5A, 0xA5 };
+  session.terminal.i2cWrite(0x50, 0x10, values, 2U);
+  mock::failTransmissions(0x50, NACK_DATA);
+  CHECK(session.terminal.flushRegisters() == NACK_DATA);
+  CHECK(mock::deviceRegisters(0x50)[0x10] == 0x00U);
+
+  CHECK(session.terminal.flushRegisters() == NO_ERROR);
+  CHECK(memcmp(&mock::deviceRegisters(0x50)[0x10], values, 2U) == 0);
+}
+
+TEST(failed_writes_keep_pending_values) {
+  Session<> session;
+  mock::addDevice(0x50);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x10, 2U));
+
+  const uint8_t pending = 0x77;
+  session.terminal.i2cWrite(0x50, 0x11, &pending, 1U);
+  uint8_t data[2];
+  session.terminal.i2cRead(0x50, 0x10, data, 2U);
+
+  // the failed write makes the clean register unknown, the dirty one stays pending
+  mock::failTransmissions(0x50, NACK_DATA);
+  CHECK_OUTPUT(session.send("i2c w 50 10 01 02\n"), "Error: I2C data recieved NACK at address 0x50\n");
+  const uint32_t requests = mock::twowireStats(0x50).requests;
+  CHECK(session.terminal.i2cRead(0x50, 0x10, data, 2U) == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).requests == (requests + 1U));
+  CHECK(data[1] == pending);
+
+  CHECK(session.terminal.flushRegisters() == NO_ERROR);
+  CHECK(mock::deviceRegisters(0x50)[0x11] == pending);
+}
+
+TEST(each_device_has_its_own_retry_budget) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::addDevice(0x51);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x00, 10U));
+  CHECK(session.terminal.cacheRegisters(0x51, 0x00, 1U));
+
+  // five separate bursts to 0x50, which retry more than a single budget
+  const uint8_t value = 0x42;
+  for (uint8_t reg = 0U; reg < 10U; reg += 2U) {
+    session.terminal.i2cWrite(0x50, reg, &value, 1U);
+  }
+  session.terminal.i2cWrite(0x51, 0x00, &value, 1U);
+  mock::failTransmissions(0x50, TIME_OUT, 100U);
+  mock::failTransmissions(0x51, TIME_OUT, 1U);
+
+  CHECK(session.terminal.flushRegisters() == TIME_OUT);
+  CHECK(mock::deviceRegisters(0x51)[0x00] == value);
+  CHECK(session.terminal.twowireRetries() == (TERM_TWOWIRE_RETRY_BUDGET + 1U));
+}
+
+TEST(i2c_write_command_writes_through) {
+  Session<> session;
+  mock::addDevice(0x50);
+  CHECK(session.terminal.cacheRegisters(0x50, 0x10, 2U));
+
+  CHECK_OUTPUT(session.send("i2c w 50 10 11 22\n"), "Write Data: 0x11 0x22\n");
+  CHECK(mock::deviceRegisters(0x50)[0x11] == 0x22U);
+  CHECK_OUTPUT(session.send("i2c r 50 10 00\n"), "Read Data: 0x11 0x22\n");
+  CHECK(mock::twowireStats(0x50).requests == 0U);
+}
+
+int main(void) {
+  return test::run();
+}
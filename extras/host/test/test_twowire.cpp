@@ -0,0 +1,314 @@
+/*
+ * test_twowire.cpp - Built-in I2C command and I2C API regression tests
+ * Copyright (C) 2024 Winry Litwa-Vulcu
+ * Licensed under the GNU General Public License, Version 3
+ */
+
+#include "harness.h"
+
+using namespace TerminalCommander;
+using namespace TerminalCommander::TerminalCommanderTypes;
+
+TEST(write_and_read_registers) {
+  Session<> session;
+  mock::addDevice(0x50);
+
+  CHECK_OUTPUT(session.send("i2c w 50 10 AA 0b\n"), "I2C Write\r\nAddress: 0x50\r\nRegister: 0x10\r\nWrite Data: 0xAA 0x0B\n");
+  CHECK((mock::deviceRegisters(0x50)[0x10] == 0xAAU) && (mock::deviceRegisters(0x50)[0x11] == 0x0BU));
+  CHECK_OUTPUT(session.send("i2c r 50 10 00\n"), "I2C Read\r\nAddress: 0x50\r\nRegister: 0x10\r\nRead Data: 0xAA 0x0B\n");
+  CHECK_OUTPUT(session.send("i2cr5010\n"), "Read Data: 0xAA\n");
+}
+
+TEST(malformed_i2c_commands) {
+  Session<> session;
+  mock::addDevice(0x50);
+
+  CHECK_OUTPUT(session.send("i2c r 50\n"), "Error: TwoWire Command requires Address and Register\n");
+  CHECK_OUTPUT(session.send("i2c r 50 1\n"), "Error: Commands must be in hex value pairs\n");
+  CHECK_OUTPUT(session.send("i2c r 50 0g\n"), "Error: Invalid TwoWire Command Character at char 11\n");
+  CHECK_OUTPUT(session.send("i2c w 50 10\n"), "Error: No data provided for write to I2C registers\n");
+  CHECK_OUTPUT(session.send("i2c x 50 10\n"), "Error: Unrecognized I2C transaction type\n");
+  CHECK(mock::twowireStats(0x50).transmissions == 0U);
+}
+
+TEST(packed_buffer_holds_a_28_byte_write) {
+  Session<BasicTerminal<128U, 10U, 30U>> session;
+  mock::addDevice(0x50);
+
+  std::string line = "i2c w 50 00";
+  for (uint8_t k = 0U; k < 28U; k++) {
+    char pair[4];
+    snprintf(pair, sizeof(pair), " %02X", k + 1U);
+    line += pair;
+  }
+  CHECK_OUTPUT(session.send(line + "\n"), "0x1B 0x1C\n");
+  CHECK((mock::deviceRegisters(0x50)[0x00] == 1U) && (mock::deviceRegisters(0x50)[0x1B] == 28U));
+  CHECK(mock::twowireStats(0x50).transmissions == 1U);
+}
+
+TEST(write_exceeding_the_packed_buffer_is_rejected) {
+  Session<BasicTerminal<128U, 10U, 30U>> session;
+  mock::addDevice(0x50);
+
+  // the 29th data byte doesn't fit next to the address and register
+  std::string line = "i2c w 50 00";
+  for (uint8_t k = 0U; k < 29U; k++) {
+    char pair[4];
+    snprintf(pair, sizeof(pair), " %02X", k + 1U);
+    line += pair;
+  }
+  CHECK_OUTPUT(session.send(line + "\n"), "Error: TwoWire Data Exceeds Buffer at char 97\n");
+  CHECK(mock::twowireStats(0x50).transmissions == 0U);
+  CHECK(mock::deviceRegisters(0x50)[0x00] == 0U);
+}
+
+TEST(dump_prints_hex_and_ascii_in_chunks) {
+  Session<> session;
+  mock::addDevice(0x50);
+  memcpy(&mock::deviceRegisters(0x50)[0x10], "Hello", 5U);
+
+  const std::string output = session.send("i2c dump 50 00 100\n");
+  CHECK(test::count(output, "|\n") == 16U);
+  CHECK_OUTPUT(output, "10: 48 65 6C 6C 6F 00 00 00 00 00 00 00 00 00 00 00  |Hello...........|\n");
+  CHECK(mock::twowireStats(0x50).requests == (0x100U / TERM_TWOWIRE_CHUNK_SIZE));
+
+  CHECK_OUTPUT(session.send("i2c d 50 10 5\n"), "10: 48 65 6C 6C 6F                                   |Hello|\n");
+  CHECK_OUTPUT(session.send("i2c dump 50 F0 20\n"), "Error: Invalid I2C read range\n");
+  CHECK_OUTPUT(session.send("i2c dump 50 00 0\n"), "Error: Invalid I2C read range\n");
+}
+
+TEST(reads_use_a_repeated_start_unless_configured) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::addDevice(0x40);
+
+  session.send("i2c r 50 00\n");
+  CHECK(mock::twowireStats(0x50).repeatedStarts == 1U);
+
+  CHECK(session.terminal.twowireDevice(0x40, 200U, false));
+  session.send("i2c r 40 00\n");
+  CHECK(mock::twowireStats(0x40).repeatedStarts == 0U);
+  CHECK(session.terminal.lastTransactionMicros() >= 200UL);
+
+  CHECK(session.terminal.twowireDevice(0x41, 0U));
+  CHECK(session.terminal.twowireDevice(0x42, 0U));
+  CHECK(session.terminal.twowireDevice(0x43, 0U));
+  CHECK(!session.terminal.twowireDevice(0x44, 0U));
+  CHECK(session.terminal.twowireDevice(0x40, 0U));
+}
+
+TEST(bus_time_of_the_last_command_is_measured) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::busMicrosPerByte(90U);
+
+  // address and register out, address and four bytes in
+  session.send("i2c r 50 00 #4\n");
+  CHECK(session.terminal.lastTransactionMicros() >= (90UL * 7UL));
+}
+
+TEST(data_nack_is_reported_without_retry) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::failTransmissions(0x50, NACK_DATA);
+
+  CHECK_OUTPUT(session.send("i2c w 50 10 AA\n"), "Error: I2C data recieved NACK at address 0x50\n");
+  CHECK(mock::twowireStats(0x50).transmissions == 1U);
+  CHECK(session.terminal.twowireErrors(NACK_DATA) == 1UL);
+  CHECK(session.terminal.twowireRetries() == 0UL);
+}
+
+TEST(timeouts_are_retried_with_backoff) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::failTransmissions(0x50, TIME_OUT, TERM_TWOWIRE_RETRIES);
+
+  const uint32_t start_us = micros();
+  CHECK_OUTPUT(session.send("i2c w 50 10 AA\n"), "Write Data: 0xAA\n");
+  CHECK((micros() - start_us) >= (3UL * TERM_TWOWIRE_BACKOFF_US));
+  CHECK(session.terminal.twowireErrors(TIME_OUT) == TERM_TWOWIRE_RETRIES);
+  CHECK(session.terminal.twowireRetries() == TERM_TWOWIRE_RETRIES);
+
+  mock::failTransmissions(0x50, TIME_OUT, 100U);
+  CHECK_OUTPUT(session.send("i2c w 50 10 AA\n"), "Error: I2C bus timeout at address 0x50\n");
+  CHECK(mock::twowireStats(0x50).transmissions == (2U * (TERM_TWOWIRE_RETRIES + 1U)));
+
+  session.terminal.resetTwoWireErrors();
+  CHECK((session.terminal.twowireErrors(TIME_OUT) == 0UL) && (session.terminal.twowireRetries() == 0UL));
+}
+
+TEST(absent_device_is_reported_with_its_address) {
+  Session<> session;
+
+  CHECK_OUTPUT(session.send("i2c r 33 00\n"), "Error: I2C address recieved NACK at address 0x33\n");
+  CHECK(session.terminal.twowireErrors(NACK_ADDRESS) == 1UL);
+
+  // an address NACK is not retried
+  CHECK(mock::twowireStats(0x33).transmissions == 1U);
+  CHECK(session.terminal.twowireRetries() == 0UL);
+}
+
+TEST(failed_chunk_ends_a_dump) {
+  Session<> session;
+  mock::addDevice(0x50);
+
+  mock::failTransmissions(0x50, TIME_OUT, 100U);
+  CHECK_OUTPUT(session.send("i2c dump 50 00 100\n"), "Error: I2C bus timeout at address 0x50\n");
+  CHECK(mock::twowireStats(0x50).transmissions == (TERM_TWOWIRE_RETRIES + 1U));
+
+  // the next command has a new budget
+  mock::failTransmissions(0x50, TIME_OUT, 1U);
+  CHECK_OUTPUT(session.send("i2c r 50 00\n"), "Read Data: 0x00\n");
+}
+
+TEST(scan_runs_across_loop_calls) {
+  Session<> session;
+  mock::addDevice(0x31);
+  mock::addDevice(0x50);
+
+  session.serial.feed("scan\n");
+  session.terminal.loop();
+  CHECK(session.terminal.busy());
+
+  uint32_t loops = 1U;
+  while (session.terminal.busy()) {
+    session.terminal.loop();
+    loops++;
+  }
+  CHECK(loops >= (127U / TERM_SCAN_PROBES_PER_LOOP));
+
+  const std::string output = session.serial.take();
+  CHECK_OUTPUT(output, "I2C device found at Address: 0x31\r\nI2C device found at Address: 0x50\r\n");
+  CHECK_OUTPUT(output, "Scan complete, 2 devices found!\r\n>> ");
+  CHECK(mock::twowireTotals().transmissions == 127U);
+}
+
+TEST(scan_without_devices) {
+  Session<> session;
+  CHECK_OUTPUT(session.send("scan\n"), "No I2C devices found :(\r\n");
+  CHECK_OUTPUT(session.send("scan foo\n"), "Error: Unrecognized Protocol\n");
+}
+
+TEST(scan_reports_probe_timeouts) {
+  Session<> session;
+  mock::failTransmissions(0x40, TIME_OUT);
+
+  CHECK_OUTPUT(session.send("scan\n"), "Timeout at Address: 0x40\r\n");
+  CHECK(session.terminal.twowireErrors(TIME_OUT) == 1UL);
+}
+
+TEST(scan_is_cancelled_by_a_line_ending) {
+  Session<> session;
+
+  session.serial.feed("scan\n");
+  session.terminal.loop();
+  session.serial.feed(" \r\n");
+  session.terminal.loop();
+  CHECK(!session.terminal.busy());
+  CHECK(session.serial.available() == 0);
+  CHECK(mock::twowireTotals().transmissions < 127U);
+
+  const std::string output = session.send("");
+  CHECK_OUTPUT(output, "Scan cancelled\r\n>> ");
+  CHECK(!test::contains(output, "Error"));
+}
+
+TEST(commands_sent_during_a_scan_cancel_it_and_run) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::deviceRegisters(0x50)[0x00] = 0x5A;
+
+  session.serial.feed("scan\n");
+  session.terminal.loop();
+  session.serial.feed("i2c r 50 00\nx");
+  const std::string output = session.send("\n");
+  CHECK_OUTPUT(output, "Scan cancelled\r\n>> ");
+  CHECK_OUTPUT(output, "Read Data: 0x5A\n");
+  CHECK_OUTPUT(output, "Error: Unrecognized Protocol\n");
+}
+
+TEST(scan_probes_with_a_short_timeout_and_restores_the_callers) {
+  Session<> session;
+  mock::addDevice(0x50);
+
+  session.send("scan\n");
+  CHECK(mock::twowireStats(0x50).timeoutMicros == TERM_SCAN_TIMEOUT_US);
+  CHECK((mock::wireTimeout() == 0UL) && !mock::wireTimeoutReset());
+
+  session.terminal.twowireTimeout(5000UL, true);
+  session.serial.feed("scan\n");
+  session.terminal.loop();
+  CHECK(session.terminal.busy());
+  CHECK((mock::wireTimeout() == 5000UL) && mock::wireTimeoutReset());
+
+  // the sketch's own transactions between scan steps use its timeout
+  session.terminal.i2cWrite(0x50, 0x00, (const uint8_t *)"\x01", 1U);
+  CHECK(mock::twowireStats(0x50).timeoutMicros == 5000UL);
+  session.send("");
+  CHECK(mock::wireTimeout() == 5000UL);
+}
+
+TEST(presence_cache_is_compiled_out_by_default) {
+  Session<> session;
+  mock::addDevice(0x50);
+  session.send("scan\n");
+  const uint32_t transmissions = mock::twowireStats(0x33).transmissions;
+
+  CHECK_OUTPUT(session.send("i2c r 33 00\n"), "Error: I2C address recieved NACK at address 0x33\n");
+  CHECK(mock::twowireStats(0x33).transmissions == (transmissions + 1U));
+  CHECK_OUTPUT(session.send("scan --delta\n"), "Error: Unrecognized Protocol\n");
+}
+
+TEST(counted_reads) {
+  Session<> session;
+  mock::addDevice(0x50);
+  for (uint16_t k = 0U; k < 0x100U; k++) {
+    mock::deviceRegisters(0x50)[k] = (uint8_t)k;
+  }
+
+  const std::string output = session.send("i2c r 50 00 #64\n");
+  CHECK_OUTPUT(output, "Read Data: 0x00 0x01 ");
+  CHECK_OUTPUT(output, " 0x3E 0x3F\n");
+  CHECK(test::count(output, "0x") == (2U + 64U));
+
+  CHECK_OUTPUT(session.send("i2c r 50 F0 #16\n"), "0xFE 0xFF\n");
+  CHECK_OUTPUT(session.send("i2c r 50 F0 #17\n"), "Error: Invalid I2C read range\n");
+  CHECK_OUTPUT(session.send("i2c r 50 00 #0\n"), "Error: Invalid I2C read range\n");
+  CHECK_OUTPUT(session.send("i2c r 50 00 00 #4\n"), "Error: Invalid I2C read range\n");
+  CHECK_OUTPUT(session.send("i2c r 50 00 #1a\n"), "Error: Invalid TwoWire Command Character at char 15\n");
+}
+
+TEST(short_reads_are_reported) {
+  Session<> session;
+  mock::addDevice(0x50);
+  mock::limitReads(0x50, 4U);
+
+  CHECK_OUTPUT(session.send("i2c r 50 00 #8\n"), "Error: I2C device returned fewer bytes than requested at address 0x50\n");
+  CHECK_OUTPUT(session.send("i2c dump 50 00 8\n"), "Error: I2C device returned fewer bytes than requested at address 0x50\n");
+}
+
+TEST(buffer_api_reads_and_writes_in_chunks) {
+  Session<> session;
+  mock::addDevice(0x50);
+
+  uint8_t data[40];
+  for (uint8_t k = 0U; k < sizeof(data); k++) {
+    data[k] = (uint8_t)(k * 3U);
+  }
+  CHECK(session.terminal.i2cWrite(0x50, 0x20, data, sizeof(data)) == NO_ERROR);
+  CHECK(mock::twowireStats(0x50).transmissions == 2U);
+  CHECK(memcmp(&mock::deviceRegisters(0x50)[0x20], data, sizeof(data)) == 0);
+
+  uint8_t readback[40] = {0};
+  CHECK(session.terminal.i2cRead(0x50, 0x20, readback, sizeof(readback)) == NO_ERROR);
+  CHECK(memcmp(readback, data, sizeof(data)) == 0);
+  CHECK(mock::twowireStats(0x50).requests == 2U);
+
+  CHECK(session.terminal.i2cRead(0x33, 0x00, readback, 1U) == NACK_ADDRESS);
+  mock::limitReads(0x50, 4U);
+  CHECK(session.terminal.i2cRead(0x50, 0x00, readback, 8U) == OTHER);
+}
+
+int main(void) {
+  return test::run();
+}
@@ -27,19 +27,66 @@ int strcmp(const char *s1, const char *s2) {
 namespace TerminalCommander {
   using namespace TerminalCommanderTypes;
 
+  #if TERM_PROFILING
+  namespace {
+    // accumulates the lifetime of a scope into a profiling stage
+    class StageTimer {
+      public:
+        StageTimer(profile_stage_t &stage) :
+          stage(stage),
+          start(micros()) {}
+
+        ~StageTimer(void) {
+          const uint32_t elapsed = micros() - this->start;
+          this->stage.calls++;
+          this->stage.total_us += elapsed;
+          if (elapsed > this->stage.max_us) {
+            this->stage.max_us = elapsed;
+          }
+        }
+
+      private:
+        profile_stage_t &stage;
+        const uint32_t start;
+    };
+  }
+
+  #define TERM_PROFILE_STAGE(name)  StageTimer stage_timer(this->stats.name)
+  #define TERM_PROFILE_COUNT(name)  (this->stats.name++)
+  #else
+  #define TERM_PROFILE_STAGE(name)
+  #define TERM_PROFILE_COUNT(name)
+  #endif
+
   // put common error messages into Program memory to save SRAM space
-  static const char strErrNoError[] PROGMEM = "No Error\n";
-  static const char strErrNoInput[] PROGMEM = "Error: No Input\n";
-  static const char strErrUndefinedUserFunctionPtr[] PROGMEM = "Error: USER function is not defined (null pointer)\n";
-  static const char strErrUnrecognizedInput[] PROGMEM = "Error: Unrecognized Input Character\n";
-  static const char strErrInvalidSerialCmdLength[] PROGMEM = "\nError: Serial Command Length Exceeds Limit\n";
-  static const char strErrIncomingTwoWireReadLength[] PROGMEM = "Error: Incoming TwoWire Data Exceeds Read Buffer\n";
-  static const char strErrInvalidTwoWireCharacter[] PROGMEM = "Error: Invalid TwoWire Command Character\n";
-  static const char strErrInvalidTwoWireCmdLength[] PROGMEM = "Error: TwoWire Command requires Address and Register\n";
-  static const char strErrInvalidTwoWireWriteData[] PROGMEM = "Error: No data provided for write to I2C registers\n";
-  static const char strErrInvalidHexValuePair[] PROGMEM = "Error: Commands must be in hex value pairs\n";
-  static const char strErrUnrecognizedProtocol[] PROGMEM = "Error: Unrecognized Protocol\n";
-  static const char strErrUnrecognizedI2CTransType[] PROGMEM = "Error: Unrecognized I2C transaction type\n";
+  static const char strErrNoError[] PROGMEM = "No Error";
+  static const char strErrNoInput[] PROGMEM = "Error: No Input";
+  static const char strErrUndefinedUserFunctionPtr[] PROGMEM = "Error: USER function is not defined (null pointer)";
+  static const char strErrUnrecognizedInput[] PROGMEM = "Error: Unrecognized Input Character";
+  static const char strErrInvalidSerialCmdLength[] PROGMEM = "\nError: Serial Command Length Exceeds Limit";
+  static const char strErrIncomingTwoWireReadLength[] PROGMEM = "Error: Incoming TwoWire Data Exceeds Read Buffer";
+  static const char strErrInvalidTwoWireCharacter[] PROGMEM = "Error: Invalid TwoWire Command Character";
+  static const char strErrInvalidTwoWireCmdLength[] PROGMEM = "Error: TwoWire Command requires Address and Register";
+  static const char strErrInvalidTwoWireWriteData[] PROGMEM = "Error: No data provided for write to I2C registers";
+  static const char strErrInvalidHexValuePair[] PROGMEM = "Error: Commands must be in hex value pairs";
+  static const char strErrUnrecognizedProtocol[] PROGMEM = "Error: Unrecognized Protocol";
+  static const char strErrUnrecognizedI2CTransType[] PROGMEM = "Error: Unrecognized I2C transaction type";
+  static const char strErrAmbiguousCommand[] PROGMEM = "Error: Ambiguous Command";
+  static const char strErrTooManyArguments[] PROGMEM = "Error: Too Many Arguments";
+  static const char strErrInvalidArgumentLength[] PROGMEM = "Error: Argument Exceeds 255 Characters";
+  static const char strErrInvalidNumber[] PROGMEM = "Error: Invalid Number";
+  static const char strErrNumberOutOfRange[] PROGMEM = "Error: Number Out of Range";
+  static const char strErrMissingArgument[] PROGMEM = "Error: Missing Argument";
+  static const char strErrInvalidArgumentSchema[] PROGMEM = "Error: Invalid Argument Schema";
+  static const char strErrInvalidTwoWireReadRange[] PROGMEM = "Error: Invalid I2C read range";
+  static const char strErrIncompleteTwoWireRead[] PROGMEM = "Error: I2C device returned fewer bytes than requested";
+  static const char strErrTwoWireDataTooLong[] PROGMEM = "Error: TwoWire Data Exceeds Buffer";
+  static const char strErrTwoWireTxBufferOverflow[] PROGMEM = "Error: I2C data exceeds the Wire transmit buffer";
+  static const char strErrTwoWireNackAddress[] PROGMEM = "Error: I2C address recieved NACK";
+  static const char strErrTwoWireNackData[] PROGMEM = "Error: I2C data recieved NACK";
+  static const char strErrTwoWireBusError[] PROGMEM = "Error: I2C bus error";
+  static const char strErrTwoWireTimeout[] PROGMEM = "Error: I2C bus timeout";
+  static const char strErrTwoWireDeviceAbsent[] PROGMEM = "Error: I2C device not present";
 
   const char *const Error::string_error_table[] PROGMEM = 
   {
@@ -54,581 +101,2508 @@ namespace TerminalCommander {
     strErrInvalidTwoWireWriteData, 
     strErrInvalidHexValuePair, 
     strErrUnrecognizedProtocol, 
-    strErrUnrecognizedI2CTransType
+    strErrUnrecognizedI2CTransType, 
+    strErrAmbiguousCommand, 
+    strErrTooManyArguments, 
+    strErrInvalidArgumentLength, 
+    strErrInvalidNumber, 
+    strErrNumberOutOfRange, 
+    strErrMissingArgument, 
+    strErrInvalidArgumentSchema, 
+    strErrInvalidTwoWireReadRange, 
+    strErrIncompleteTwoWireRead, 
+    strErrTwoWireDataTooLong, 
+    strErrTwoWireTxBufferOverflow, 
+    strErrTwoWireNackAddress, 
+    strErrTwoWireNackData, 
+    strErrTwoWireBusError, 
+    strErrTwoWireTimeout, 
+    strErrTwoWireDeviceAbsent
   };
 
-  Error::Error(void):
-    flag(false), 
-    warning(false), 
-    type(NoError) {};
+  // built-in command names, used to resolve abbreviated commands
+  static const char strCmdI2C[] PROGMEM = "i2c";
+  static const char strCmdScan[] PROGMEM = "scan";
+
+  static const char *const builtin_command_table[] PROGMEM = 
+  {
+    strCmdI2C, 
+    strCmdScan
+  };
+
+  // optional remainder of the 'i2c d' transaction type, skipped by the lexer
+  static const char strCmdI2CDump[] PROGMEM = "ump";
+
+  // only argument of the 'scan' command
+  static const char strCmdScanDelta[] PROGMEM = "--delta";
+
+  // bytes printed per line of an 'i2c dump'
+  #define TERM_HEXDUMP_LINE_SIZE  (16U)
 
-  void Error::set(TerminalCommanderTypes::error_type_t error_type) {
-    this->flag = true;
-    this->type = error_type;
-    memset(message, '\0', TERM_ERROR_MESSAGE_SIZE);
-    strcpy_P(message, (char *)pgm_read_ptr(&(this->string_error_table[error_type])));
+  // retry budget address of a new command, beyond any 7-bit I2C address
+  static const uint8_t TwoWireNoAddress = 0x80U;
+
+  // character classes used for input validation, hex values are held in the low nibble
+  enum char_class_t {
+    CharInvalid   = 0x00U,
+    CharSpace     = 0x10U,  // whitespace: ' ', '\t', '\n', '\v', '\f', '\r'
+    CharSeparator = 0x20U,  // argument separators: ',' and ';'
+    CharSymbol    = 0x30U,  // symbols for negative and decimal values and counts: '-', '.' and '#'
+    CharLetter    = 0x40U,  // letters [g-z] and [G-Z]
+    CharDigit     = 0x50U,  // numbers [0-9]
+    CharHexLetter = 0x60U,  // letters [a-f] and [A-F]
+  };
+
+  #define TERM_CHAR_CLASS_MASK  (0xF0U)
+  #define TERM_CHAR_VALUE_MASK  (0x0FU)
+
+  static constexpr uint8_t charClassOf(uint8_t c) {
+    return ((c >= '0') && (c <= '9')) ? (uint8_t)(CharDigit | (c - '0')) :
+           ((c >= 'A') && (c <= 'F')) ? (uint8_t)(CharHexLetter | (c - 'A' + 10U)) :
+           ((c >= 'a') && (c <= 'f')) ? (uint8_t)(CharHexLetter | (c - 'a' + 10U)) :
+           ((c >= 'G') && (c <= 'Z')) ? (uint8_t)CharLetter :
+           ((c >= 'g') && (c <= 'z')) ? (uint8_t)CharLetter :
+           ((c == ' ') || ((c >= '\t') && (c <= '\r'))) ? (uint8_t)CharSpace :
+           ((c == ',') || (c == ';')) ? (uint8_t)CharSeparator :
+           ((c == '-') || (c == '.') || (c == '#')) ? (uint8_t)CharSymbol : (uint8_t)CharInvalid;
   }
 
-  void Error::warn(TerminalCommanderTypes::error_type_t error_type) {
-    this->warning = true;
-    this->set(error_type);
+  #define TERM_CHAR_CLASS_4(c)   charClassOf(c), charClassOf(c + 1U), \
+                                 charClassOf(c + 2U), charClassOf(c + 3U)
+  #define TERM_CHAR_CLASS_16(c)  TERM_CHAR_CLASS_4(c), TERM_CHAR_CLASS_4(c + 4U), \
+                                 TERM_CHAR_CLASS_4(c + 8U), TERM_CHAR_CLASS_4(c + 12U)
+  #define TERM_CHAR_CLASS_64(c)  TERM_CHAR_CLASS_16(c), TERM_CHAR_CLASS_16(c + 16U), \
+                                 TERM_CHAR_CLASS_16(c + 32U), TERM_CHAR_CLASS_16(c + 48U)
+
+  // class of every 7-bit ASCII character, generated at compile time and kept in PROGMEM
+  static const uint8_t char_class_table[128] PROGMEM = {
+    TERM_CHAR_CLASS_64(0U), 
+    TERM_CHAR_CLASS_64(64U)
+  };
+
+  static inline uint8_t charClass(char c) {
+    // anything outside of 7-bit ASCII is not permitted
+    return ((uint8_t)c < 128U) ? pgm_read_byte(&char_class_table[(uint8_t)c]) : (uint8_t)CharInvalid;
   }
 
-  void Error::clear(void) {
-    this->flag    = false;
-    this->warning = false;
-    this->type    = NoError;
+  // strcmp() of the null-terminated name against the length chars at span,
+  // or of only the first length chars of the name if is_prefix is set
+  static int compareCommand(const char *name, const char *span, size_t length, bool is_prefix = false) {
+    for (size_t k = 0; k < length; k++) {
+      if (name[k] != span[k]) {
+        // also covers name being shorter than span, since '\0' < span[k]
+        return (int)(uint8_t)name[k] - (int)(uint8_t)span[k];
+      }
+    }
+    return (is_prefix || (name[length] == '\0')) ? 0 : 1;
   }
 
-  void Error::reset(void) {
-    this->clear();
-    memset(this->message,  '\0', sizeof(this->message));
+  // compareCommand() of a null-terminated name stored in PROGMEM
+  static int compareCommand_P(const char *name_P, const char *span, size_t length, bool is_prefix = false) {
+    for (size_t k = 0; k < length; k++) {
+      const char c = (char)pgm_read_byte(&name_P[k]);
+      if (c != span[k]) {
+        return (int)(uint8_t)c - (int)(uint8_t)span[k];
+      }
+    }
+    return (is_prefix || (pgm_read_byte(&name_P[length]) == '\0')) ? 0 : 1;
   }
 
-  Command::Command(void): 
-    pArgs(nullptr),
-    iArgs(0U), 
-    cmdLength(0U), 
-    argsLength(0U), 
-    index(0U), 
-    complete(false), 
-    overflow(false) {}
+  // true if the span is a prefix of the lower-case name in PROGMEM, ignoring case
+  static bool isBuiltInPrefix(const char *name_P, const char *span, size_t length) {
+    for (size_t k = 0; k < length; k++) {
+      // setting bit 5 lower-cases letters and leaves all other permitted chars unchanged
+      if ((char)pgm_read_byte(&name_P[k]) != (char)(span[k] | 0x20)) {
+        return false;
+      }
+    }
+    return true;
+  }
 
-  void Command::next(char character) {
-    if (character == TERM_LINE_ENDING) {
-      this->complete = true;
-      return;
-    } 
-    
-    if (index >= TERM_CHAR_BUFFER_SIZE) {
-      this->overflow = true;
-      return;
+  // upper-case ASCII hex digit of each nibble value
+  static const char hex_digit_table[] PROGMEM = "0123456789ABCDEF";
+
+  static inline char hexDigit(uint8_t nibble) {
+    return (char)pgm_read_byte(&hex_digit_table[nibble & 0x0FU]);
+  }
+
+  // accumulate decimal digits from p up to end into value, stopping at the first
+  // non-digit, returns NumberOutOfRange if the value would exceed limit
+  static error_type_t parseDigits(const char *&p, const char *end, const uint32_t limit, uint32_t &value) {
+    while (p < end) {
+      const uint8_t char_class = charClass(*p);
+      if ((char_class & TERM_CHAR_CLASS_MASK) != CharDigit) {
+        break;
+      }
+      const uint8_t digit = char_class & TERM_CHAR_VALUE_MASK;
+      if (value > ((limit - digit) / 10U)) {
+        return NumberOutOfRange;
+      }
+      value = (value * 10U) + digit;
+      p++;
     }
-    
-    serialRx[this->index++] = character;
+    return NoError;
   }
 
-  void Command::previous(void) {
-    if (this->index > 0) {
-      serialRx[--this->index] = '\0';
+  static const uint32_t powers_of_ten[] PROGMEM = 
+  {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+  };
+
+  static inline uint32_t powerOfTen(uint8_t exponent) {
+    return pgm_read_dword(&powers_of_ten[exponent]);
+  }
+
+  error_type_t parseUInt(const token_t &token, uint32_t &value) {
+    const char *p = token.ptr;
+    const char *end = token.ptr + token.len;
+    uint32_t result = 0UL;
+    if (token.len == 0U) {
+      return InvalidNumber;
+    }
+
+    const error_type_t error = parseDigits(p, end, UINT32_MAX, result);
+    if (error != NoError) {
+      return error;
     }
+    if (p != end) {
+      return InvalidNumber;
+    }
+    value = result;
+    return NoError;
   }
 
-  void Command::flushInput(void) {
-    memset(this->serialRx,  '\0', sizeof(this->serialRx));
-    this->complete = false;
-    this->overflow = false;
+  error_type_t parseInt(const token_t &token, int32_t &value) {
+    const bool isNegative = (token.len > 0U) && (token.ptr[0] == '-');
+    const token_t digits = { token.ptr + (isNegative ? 1 : 0), (uint8_t)(token.len - (isNegative ? 1U : 0U)) };
+    uint32_t magnitude = 0UL;
+
+    // parse the magnitude against the limit of the sign, |INT32_MIN| = INT32_MAX + 1
+    const char *p = digits.ptr;
+    if (digits.len == 0U) {
+      return InvalidNumber;
+    }
+    const error_type_t error = parseDigits(p, digits.ptr + digits.len, 
+                                           (uint32_t)INT32_MAX + (isNegative ? 1UL : 0UL), magnitude);
+    if (error != NoError) {
+      return error;
+    }
+    if (p != (digits.ptr + digits.len)) {
+      return InvalidNumber;
+    }
+    value = isNegative ? (int32_t)(0UL - magnitude) : (int32_t)magnitude;
+    return NoError;
   }
 
-  void Command::flushTwoWire(void) {
-    memset(this->twowire, 0, sizeof(this->twowire));
+  error_type_t parseHex(const token_t &token, uint32_t &value) {
+    const char *p = token.ptr;
+    const char *end = token.ptr + token.len;
+    if ((token.len > 2U) && (p[0] == '0') && ((p[1] | 0x20) == 'x')) {
+      p += 2;
+    }
+    if (p == end) {
+      return InvalidNumber;
+    }
+
+    uint32_t result = 0UL;
+    for (; p < end; p++) {
+      const uint8_t char_class = charClass(*p);
+      if ((char_class & TERM_CHAR_CLASS_MASK) < CharDigit) {
+        return InvalidNumber;
+      }
+      if ((result >> 28) != 0UL) {
+        return NumberOutOfRange;
+      }
+      result = (result << 4) | (char_class & TERM_CHAR_VALUE_MASK);
+    }
+    value = result;
+    return NoError;
   }
 
-  void Command::initialize(void) {
-    this->pArgs       = nullptr;
-    this->iArgs       = 0U;
-    this->cmdLength   = 0U;
-    this->argsLength  = 0U;
-    this->index       = 0U;
-    this->flushTwoWire();
-    memset(this->data, '\0', sizeof(this->data));
+  error_type_t parseFixed(const token_t &token, const uint8_t fraction_digits, int32_t &value) {
+    const char *p = token.ptr;
+    const char *end = token.ptr + token.len;
+    const bool isNegative = (p < end) && (*p == '-');
+    if (isNegative) {
+      p++;
+    }
+    if (fraction_digits > 9U) {
+      return NumberOutOfRange;
+    }
+
+    const uint32_t limit = (uint32_t)INT32_MAX + (isNegative ? 1UL : 0UL);
+    const char *start = p;
+    uint32_t result = 0UL;
+    error_type_t error = parseDigits(p, end, limit, result);
+    if (error != NoError) {
+      return error;
+    }
+    bool hasDigits = (p != start);
+
+    // scale the integer part, then add the fraction digits one at a time
+    const uint32_t scale = powerOfTen(fraction_digits);
+    if (result > (limit / scale)) {
+      return NumberOutOfRange;
+    }
+    result *= scale;
+
+    if ((p < end) && (*p == '.')) {
+      p++;
+      uint32_t place = scale;
+      for (; (p < end) && ((charClass(*p) & TERM_CHAR_CLASS_MASK) == CharDigit); p++) {
+        const uint8_t digit = charClass(*p) & TERM_CHAR_VALUE_MASK;
+        hasDigits = true;
+        if (place > 1UL) {
+          place /= 10U;
+          if (digit > ((limit - result) / place)) {
+            return NumberOutOfRange;
+          }
+          result += digit * place;
+        }
+        else if (place == 1UL) {
+          // first digit beyond the fraction digits, round half away from zero
+          place = 0UL;
+          if (digit >= 5U) {
+            if (result == limit) {
+              return NumberOutOfRange;
+            }
+            result++;
+          }
+        }
+      }
+    }
+
+    if (!hasDigits || (p != end)) {
+      return InvalidNumber;
+    }
+    value = isNegative ? (int32_t)(0UL - result) : (int32_t)result;
+    return NoError;
   }
 
-  void Command::reset(void) {
-    this->flushInput();
-    this->initialize();
+  error_type_t parseFloat(const token_t &token, float &value) {
+    const char *p = token.ptr;
+    const char *end = token.ptr + token.len;
+    const bool isNegative = (p < end) && (*p == '-');
+    if (isNegative) {
+      p++;
+    }
+
+    // collect up to 9 significant digits into an integer mantissa
+    uint32_t mantissa = 0UL;
+    int16_t exponent = 0;
+    uint8_t significant = 0U;
+    bool hasDigits = false;
+    bool isFraction = false;
+    for (; p < end; p++) {
+      const uint8_t char_class = charClass(*p);
+      if ((*p == '.') && !isFraction) {
+        isFraction = true;
+        continue;
+      }
+      if ((char_class & TERM_CHAR_CLASS_MASK) != CharDigit) {
+        break;
+      }
+      const uint8_t digit = char_class & TERM_CHAR_VALUE_MASK;
+      hasDigits = true;
+      if (significant < 9U) {
+        if ((mantissa != 0UL) || (digit != 0U)) {
+          // leading zeros are not significant
+          mantissa = (mantissa * 10U) + digit;
+          significant++;
+        }
+        if (isFraction) {
+          exponent--;
+        }
+      }
+      else if (!isFraction) {
+        // integer digit beyond the significant digits
+        exponent++;
+      }
+    }
+    if (!hasDigits) {
+      return InvalidNumber;
+    }
+
+    if ((p < end) && ((*p | 0x20) == 'e')) {
+      p++;
+      int32_t exponent_value = 0;
+      const token_t exponent_token = { p, (uint8_t)(end - p) };
+      const error_type_t error = parseInt(exponent_token, exponent_value);
+      if (error != NoError) {
+        return error;
+      }
+      if ((exponent_value > 99) || (exponent_value < -99)) {
+        return NumberOutOfRange;
+      }
+      exponent += (int16_t)exponent_value;
+      p = end;
+    }
+    if (p != end) {
+      return InvalidNumber;
+    }
+
+    // apply the decimal exponent in steps of at most 10^9, which are exact as float
+    float result = (float)mantissa;
+    const bool isExponentNegative = (exponent < 0);
+    uint16_t remaining = (uint16_t)(isExponentNegative ? -exponent : exponent);
+    while (remaining > 0U) {
+      const uint8_t step = (remaining > 9U) ? 9U : (uint8_t)remaining;
+      const float scale = (float)powerOfTen(step);
+      result = isExponentNegative ? (result / scale) : (result * scale);
+      remaining -= step;
+    }
+
+    if (isinf(result) || ((mantissa != 0UL) && (result == 0.0f))) {
+      return NumberOutOfRange;
+    }
+    value = isNegative ? -result : result;
+    return NoError;
   }
 
-  Terminal::Terminal(Stream* pSerial, 
-    TwoWire* pWire) :
-    termCommandDelimiter(TERM_DEFAULT_CMD_DELIMITER) {
-    this->pSerial = pSerial;
-    this->pWire = pWire;
+  // conversion of a single schema argument type
+  enum schema_kind_t {
+    SchemaNone = 0,
+    SchemaInt, 
+    SchemaUInt, 
+    SchemaHex, 
+    SchemaFixed, 
+    SchemaFloat, 
+    SchemaString, 
   };
 
-  Terminal::Terminal(Stream* pSerial, 
-    TwoWire* pWire,
-    const char command_delimiter = TERM_DEFAULT_CMD_DELIMITER) :
-    termCommandDelimiter(command_delimiter) {
-    this->pSerial = pSerial;
-    this->pWire = pWire;
+  struct schema_arg_t {
+    schema_kind_t kind;
+    uint8_t bits;       // integer width, or fraction digits for SchemaFixed
+    bool isOptional;    // '?' suffix
+    bool isRepeated;    // '*' suffix
   };
 
-  void Terminal::loop(void) {
-    while(this->pSerial->available() > 0) {
-      // check for buffer overflow
-      if (this->command.overflow) {
-        break;
-      }      
+  // true if the length chars at name equal the null-terminated keyword
+  static bool isSchemaKeyword(const char *name, size_t length, const char *keyword) {
+    return (strncmp(name, keyword, length) == 0) && (keyword[length] == '\0');
+  }
 
-      // get the new byte
-      char c = (char)this->pSerial->read();
+  // read the next argument type of the schema, kind is SchemaNone at the end
+  static error_type_t nextSchemaArg(const char *&schema, schema_arg_t &arg) {
+    arg = { SchemaNone, 0U, false, false };
+    while (*schema == ' ') {
+      schema++;
+    }
+    if (*schema == '\0') {
+      return NoError;
+    }
 
-      // Could add handling here for ASCII '27' escape sequence indicator e.g.
-      // \033[A = VT100 Up Cursor Key      \033[B = VT100 Down Cursor Key
-      // \033[C = VT100 Right Cursor Key   \033[D = VT100 Left Cursor Key
-      if ((uint8_t)c == 8U) {
-        // ASCII character '8' is backspace
-        if (this->isEchoEnabled && (this->command.index > 0)) {
-          // VT100 destructive backspace (delete from terminal output) is "\b \b"
-          this->pSerial->print(F("\b \b"));
-        }
-        this->command.previous();
+    const char *name = schema;
+    while ((*schema != '\0') && (*schema != ' ') && (*schema != '?') && (*schema != '*')) {
+      schema++;
+    }
+    const size_t length = (size_t)(schema - name);
+    if (*schema == '?') {
+      arg.isOptional = true;
+      schema++;
+    }
+    else if (*schema == '*') {
+      arg.isRepeated = true;
+      schema++;
+    }
+
+    if ((length == 4U) && (strncmp(name, "fix", 3U) == 0) && (name[3] >= '0') && (name[3] <= '9')) {
+      arg.kind = SchemaFixed;
+      arg.bits = (uint8_t)(name[3] - '0');
+    }
+    else if (isSchemaKeyword(name, length, "hex")) {
+      arg.kind = SchemaHex;
+      arg.bits = 32U;
+    }
+    else if (isSchemaKeyword(name, length, "float")) {
+      arg.kind = SchemaFloat;
+    }
+    else if (isSchemaKeyword(name, length, "str")) {
+      arg.kind = SchemaString;
+    }
+    else if ((name[0] == 'i') || (name[0] == 'u')) {
+      arg.kind = (name[0] == 'i') ? SchemaInt : SchemaUInt;
+      arg.bits = isSchemaKeyword(name + 1, length - 1U, "8")  ?  8U : 
+                 isSchemaKeyword(name + 1, length - 1U, "16") ? 16U : 
+                 isSchemaKeyword(name + 1, length - 1U, "32") ? 32U : 0U;
+      if (arg.bits == 0U) {
+        return InvalidArgumentSchema;
       }
-      else {
-        if (this->isEchoEnabled) {
-          this->pSerial->print(c);
+    }
+    else {
+      return InvalidArgumentSchema;
+    }
+    return NoError;
+  }
+
+  // a compiled type code holds the schema_kind_t in bits 4-6 and the integer width
+  // as a power of two, or the fraction digits of SchemaFixed, in bits 0-3
+  static const uint8_t SchemaKindShift = 4U;
+  static const uint8_t SchemaParamMask = 0x0FU;
+  static const uint8_t SchemaRepeated  = 0x80U;   // set on a repeated last type
+
+  // validate a schema and compile it into one type code per argument
+  static error_type_t compileSchema(const char *schema, arg_schema_t &compiled) {
+    compiled.count = 0U;
+    compiled.required = 0U;
+    if (schema == nullptr) {
+      return NoError;
+    }
+
+    schema_arg_t arg = { SchemaNone, 0U, false, false };
+    while (true) {
+      const bool isPreviousRepeated = arg.isRepeated;
+      const error_type_t error = nextSchemaArg(schema, arg);
+      if (error != NoError) {
+        return error;
+      }
+      if (arg.kind == SchemaNone) {
+        return NoError;
+      }
+      if (isPreviousRepeated || (compiled.count >= TERM_MAX_ARGS)) {
+        // a repeated type must be the last, and no more args than tokens
+        return InvalidArgumentSchema;
+      }
+      if (!arg.isOptional && !arg.isRepeated) {
+        if (compiled.required < compiled.count) {
+          // a required argument can't follow an optional one
+          return InvalidArgumentSchema;
         }
-        this->command.next(c);
+        compiled.required++;
       }
-    };
 
-    if (this->command.overflow) {
-      // wait for next chararcter in case command is still being transmitted
-      delayMicroseconds(TERM_MICROSEC_PER_CHAR);
+      const uint8_t param = (arg.kind == SchemaFixed) ? arg.bits : 
+                            (arg.bits == 8U) ? 3U : (arg.bits == 16U) ? 4U : (arg.bits == 32U) ? 5U : 0U;
+      compiled.types[compiled.count++] = (uint8_t)(((uint8_t)arg.kind << SchemaKindShift) | param | 
+                                                   (arg.isRepeated ? SchemaRepeated : 0U));
+    }
+  }
 
-      // discard incoming data until the serial line ending is received
-      while (this->pSerial->available() > 0) {
-        if ((char)this->pSerial->read() == TERM_LINE_ENDING) {
-          break;
+  // validate a schema held in PROGMEM by a command table entry and compile it
+  static error_type_t compileSchema_P(const char *schema_P, arg_schema_t &compiled) {
+    char schema[TERM_PROGMEM_SCHEMA_SIZE];
+    memcpy_P(schema, schema_P, sizeof(schema));
+    return compileSchema(schema, compiled);
+  }
+
+  // convert a single token according to its compiled type code
+  static error_type_t parseSchemaArg(uint8_t type, const token_t &token, arg_value_t &value) {
+    const uint8_t param = type & SchemaParamMask;
+    error_type_t error = NoError;
+    switch ((schema_kind_t)((type & ~SchemaRepeated) >> SchemaKindShift)) {
+      case SchemaInt:
+        error = parseInt(token, value.i);
+        if ((error == NoError) && (param < 5U)) {
+          const int32_t limit = (int32_t)1 << ((1U << param) - 1U);
+          if ((value.i < -limit) || (value.i >= limit)) {
+            error = NumberOutOfRange;
+          }
+        }
+        break;
+      case SchemaUInt:
+        error = parseUInt(token, value.u);
+        if ((error == NoError) && (param < 5U) && ((value.u >> (1U << param)) != 0UL)) {
+          error = NumberOutOfRange;
         }
-        // wait to see if another new character will arrive
-        delayMicroseconds(TERM_MICROSEC_PER_CHAR);
+        break;
+      case SchemaHex:
+        error = parseHex(token, value.u);
+        break;
+      case SchemaFixed:
+        error = parseFixed(token, param, value.i);
+        break;
+      case SchemaFloat:
+        error = parseFloat(token, value.f);
+        break;
+      case SchemaString:
+        value.s = token;
+        break;
+      default:
+        error = InvalidArgumentSchema;
+        break;
+    }
+    return error;
+  }
+
+  // convert all tokens according to the compiled schema, failed is the index of
+  // the token which caused an error, if any
+  static error_type_t parseSchemaArgs(const arg_schema_t &schema, const token_t *tokens, uint8_t count, 
+                                      arg_value_t *values, uint8_t &failed) {
+    const bool isLastRepeated = (schema.count > 0U) && ((schema.types[schema.count - 1U] & SchemaRepeated) != 0U);
+    failed = count;
+    for (uint8_t k = 0U; k < count; k++) {
+      if ((k >= schema.count) && !isLastRepeated) {
+        failed = k;
+        return TooManyArguments;
       }
-      this->lastError.set(InvalidSerialCmdLength);
-      this->pSerial->print(this->lastError.message);
-      this->lastError.clear();
-      this->command.reset();
-      this->isNewTerminalCommandPrompt = true;
+      const uint8_t type = schema.types[(k < schema.count) ? k : (uint8_t)(schema.count - 1U)];
+      const error_type_t error = parseSchemaArg(type, tokens[k], values[k]);
+      if (error != NoError) {
+        failed = k;
+        return error;
+      }
+    }
+    return (count < schema.required) ? MissingArgument : NoError;
+  }
+
+  // copy a PROGMEM command table entry into the form used for dispatch
+  static user_callback_char_t readUserCallback_P(const user_callback_P_t *entry) {
+    user_callback_char_t user_callback;
+    user_callback.command = entry->command;
+    user_callback.schema = nullptr;
+    if (pgm_read_ptr(&entry->args) != nullptr) {
+      user_callback.args = (user_callback_args_fn_t*)pgm_read_ptr(&entry->args);
+      user_callback.schema = entry->schema;
+      user_callback.type = ArgsCallback_P;
+    }
+    else if (pgm_read_ptr(&entry->argv) != nullptr) {
+      user_callback.argv = (user_callback_argv_fn_t*)pgm_read_ptr(&entry->argv);
+      user_callback.type = ArgvCallback;
+    }
+    else {
+      user_callback.callback = (user_callback_char_fn_t*)pgm_read_ptr(&entry->callback);
+      user_callback.type = CharCallback;
+    }
+    return user_callback;
+  }
+
+  Error::Error(void):
+    flag(false), 
+    warning(false), 
+    type(NoError), 
+    contextType(NoContext), 
+    context(0U) {};
+
+  void Error::set(TerminalCommanderTypes::error_type_t error_type, 
+                  TerminalCommanderTypes::error_context_t context_type, 
+                  uint16_t context) {
+    this->flag        = true;
+    this->type        = error_type;
+    this->contextType = context_type;
+    this->context     = context;
+  }
+
+  void Error::warn(TerminalCommanderTypes::error_type_t error_type, 
+                   TerminalCommanderTypes::error_context_t context_type, 
+                   uint16_t context) {
+    this->warning = true;
+    this->set(error_type, context_type, context);
+  }
+
+  void Error::clear(void) {
+    this->flag    = false;
+    this->warning = false;
+    this->type    = NoError;
+  }
+
+  void Error::reset(void) {
+    this->clear();
+    this->contextType = NoContext;
+    this->context     = 0U;
+  }
+
+  const __FlashStringHelper *Error::message(void) const {
+    return (const __FlashStringHelper *)pgm_read_ptr(&(this->string_error_table[this->type]));
+  }
+
+  size_t Error::printTo(Print &output) const {
+    size_t n = output.print(this->message());
+    if (this->contextType == CharPosition) {
+      n += output.print(F(" at char "));
+      n += output.print(this->context);
+    }
+    else if (this->contextType == TwoWireAddress) {
+      const char address[2] = { hexDigit((uint8_t)this->context >> 4), hexDigit((uint8_t)this->context) };
+      n += output.print(F(" at address 0x"));
+      n += output.write(address, sizeof(address));
+    }
+    n += output.print('\n');
+    return n;
+  }
+
+  Output::Output(Stream *stream, uint8_t *buffer, const size_t buffer_size):
+    pStream(stream), 
+    buffer(buffer), 
+    bufferSize(buffer_size), 
+    head(0U), 
+    length(0U), 
+    droppedBytes(0UL), 
+    flushPolicy(FlushPerResponse), 
+    backpressurePolicy(TxBlock), 
+    isTruncating(false), 
+    isLineEndingOwed(false), 
+    isLineEndingDropped(false), 
+    isStalled(false) {}
+
+  size_t Output::write(uint8_t data) {
+    if (this->length >= this->bufferSize) {
+      this->flush();
+    }
+
+    if (this->isLineEndingOwed && (this->length < this->bufferSize)) {
+      // terminate the truncated line before any further output, a line which is
+      // still being truncated has nothing staged so its line ending is not needed
+      this->push('\n');
+      this->isLineEndingOwed = false;
+      this->isLineEndingDropped = this->isTruncating;
     }
-    else if (this->command.complete) {
-      this->serialCommandProcessor();
 
-      if (this->lastError.flag) {
-        this->pSerial->print(this->lastError.message);
-        this->lastError.clear();
+    if (this->length >= this->bufferSize) {
+      // the Stream can't accept more output right now, or with TxBlock has
+      // stopped accepting output altogether
+      this->droppedBytes++;
+      if (this->backpressurePolicy == TxTruncate) {
+        this->isLineEndingOwed = this->isLineEndingOwed || (data == '\n');
+        this->isTruncating = (data != '\n');
+      }
+      return 1U;
+    }
+    else if (this->isTruncating) {
+      // drop the rest of the line, but keep its line ending
+      this->isTruncating = (data != '\n');
+      if (this->isTruncating || this->isLineEndingDropped) {
+        this->isLineEndingDropped = this->isTruncating;
+        this->droppedBytes++;
+        return 1U;
       }
+    }
 
-      // clear the input buffer array and reset serial logic
-      this->command.reset();
-      this->isNewTerminalCommandPrompt = true;
+    this->push(data);
+
+    if ((data == '\n') && (this->flushPolicy == FlushPerLine)) {
+      this->flush();
     }
+    return 1U;
+  }
 
-    if (this->isNewTerminalCommandPrompt) {
-      this->isNewTerminalCommandPrompt = false;
-      this->pSerial->print(F(">> "));
+  size_t Output::printHex(const uint8_t *data, size_t size, hex_format_t format) {
+    size_t n = 0U;
+    for (size_t k = 0; k < size; k++) {
+      if (k > 0U) {
+        n += Output::write((uint8_t)' ');
+      }
+      if (format == HexPrefixed) {
+        n += Output::write((uint8_t)'0');
+        n += Output::write((uint8_t)'x');
+      }
+      n += Output::write((uint8_t)hexDigit(data[k] >> 4));
+      n += Output::write((uint8_t)hexDigit(data[k]));
     }
+    return n;
   }
 
-  void Terminal::initialize(void) {
-    this->lastError.clear();
-    this->command.reset();
-    this->pSerial->print(F("\n"));
+  void Output::push(uint8_t data) {
+    size_t tail = this->head + this->length;
+    if (tail >= this->bufferSize) {
+      tail -= this->bufferSize;
+    }
+    this->buffer[tail] = data;
+    this->length++;
   }
 
-  void Terminal::echo(bool enable_terminal_echo) {
-    this->isEchoEnabled = enable_terminal_echo;
+  size_t Output::write(const uint8_t *data, size_t size) {
+    for (size_t k = 0; k < size; k++) {
+      this->write(data[k]);
+    }
+    return size;
+  }
+
+  void Output::flush(void) {
+    if (this->length == 0U) {
+      return;
+    }
+
+    if (this->backpressurePolicy == TxBlock) {
+      this->drain(this->length);
+    }
+    else {
+      const int available = this->pStream->availableForWrite();
+      if (available > 0) {
+        this->drain((size_t)available);
+      }
+    }
+  }
+
+  void Output::drain(size_t limit) {
+    uint32_t progress_ms = millis();
+    while ((this->length > 0U) && (limit > 0U)) {
+      // write the contiguous bytes up to the end of the buffer, then wrap
+      size_t chunk = this->bufferSize - this->head;
+      if (chunk > this->length) {
+        chunk = this->length;
+      }
+      if (chunk > limit) {
+        chunk = limit;
+      }
+
+      const size_t written = this->pStream->write(&this->buffer[this->head], chunk);
+      this->head += written;
+      if (this->head >= this->bufferSize) {
+        this->head = 0U;
+      }
+      this->length -= written;
+      limit -= written;
+
+      if (written > 0U) {
+        progress_ms = millis();
+        this->isStalled = false;
+      }
+      if (written < chunk) {
+        if ((this->backpressurePolicy != TxBlock) || this->isStalled) {
+          // the Stream accepted less than requested, try again on the next flush
+          break;
+        }
+        if ((millis() - progress_ms) >= TERM_TX_BLOCK_TIMEOUT_MS) {
+          // don't wait on every following byte for a Stream which accepts nothing
+          this->isStalled = true;
+          break;
+        }
+      }
+    }
+
+    if (this->length == 0U) {
+      this->head = 0U;
+    }
+  }
+
+  void Output::backpressure(backpressure_t backpressure_policy) {
+    this->backpressurePolicy = backpressure_policy;
   }
 
-  void Terminal::onCommand(const char* command, user_callback_char_fn_t callback) {
-    this->userCharCallbacks[this->numUserCharCallbacks] = { command, callback };
-    this->numUserCharCallbacks++;
+  uint32_t Output::dropped(void) const {
+    return this->droppedBytes;
+  }
+
+  void Output::resetDropped(void) {
+    this->droppedBytes = 0UL;
+  }
+
+  void Output::policy(flush_policy_t flush_policy) {
+    this->flushPolicy = flush_policy;
+  }
+
+  flush_policy_t Output::policy(void) const {
+    return this->flushPolicy;
+  }
+
+  template <typename index_t>
+  Command<index_t>::Command(char *serial_rx, 
+    const index_t buffer_size, 
+    uint8_t *twowire, 
+    const index_t twowire_size, 
+    const char command_delimiter): 
+    serialRx(serial_rx), 
+    twowire(twowire), 
+    bufferSize(buffer_size), 
+    twowireSize(twowire_size), 
+    pArgs(nullptr),
+    iArgs(0U), 
+    cmdStart(0U), 
+    cmdLength(0U), 
+    userArgsLength(0U), 
+    charCount(0U), 
+    prefix{'\0'}, 
+    twowireLength(0U), 
+    readCount(0U), 
+    isReadCounted(false), 
+    inputError(NoError), 
+    inputErrorIndex(0U), 
+    twowireError(NoError), 
+    twowireErrorIndex(0U), 
+    index(0U), 
+    complete(false), 
+    overflow(false), 
+    delimiter(command_delimiter) {}
+
+  template <typename index_t>
+  void Command<index_t>::next(char character) {
+    if (character == TERM_LINE_ENDING) {
+      this->complete = true;
+      this->finalize();
+      return;
+    } 
+
+    if (this->overflow) {
+      // discard incoming data until the serial line ending is received
+      return;
+    }
+
+    if (this->index >= this->bufferSize) {
+      this->overflow = true;
+      return;
+    }
+    
+    serialRx[this->index] = character;
+    this->lex(this->index++);
+  }
+
+  template <typename index_t>
+  void Command<index_t>::previous(void) {
+    if ((this->index > 0) && !this->overflow) {
+      serialRx[--this->index] = '\0';
+
+      // lexer state can't be unwound, so lex the remaining characters again
+      this->resetLexer();
+      for (index_t idx = 0; idx < this->index; idx++) {
+        this->lex(idx);
+      }
+    }
+  }
+
+  template <typename index_t>
+  bool Command<index_t>::expand(const char *name_P) {
+    const index_t name_length = (index_t)strlen_P(name_P);
+    const index_t cmd_end = this->cmdStart + this->cmdLength;
+    if ((name_length < this->cmdLength) || 
+        ((this->bufferSize - this->index) < (name_length - this->cmdLength))) {
+      return false;
+    }
+
+    // the chars beyond index are all '\0', so the line stays null-terminated
+    memmove(&this->serialRx[this->cmdStart + name_length], &this->serialRx[cmd_end], this->index - cmd_end);
+    memcpy_P(&this->serialRx[this->cmdStart], name_P, name_length);
+    this->index += name_length - this->cmdLength;
+
+    this->resetLexer();
+    for (index_t idx = 0; idx < this->index; idx++) {
+      this->lex(idx);
+    }
+    this->finalize();
+    return true;
+  }
+
+  template <typename index_t>
+  error_type_t Command<index_t>::tokenize(token_t *tokens, const uint8_t max_tokens, uint8_t &count) const {
+    bool isToken = false;
+    count = 0U;
+    for (index_t k = 0; k < this->userArgsLength; k++) {
+      const char c = this->pArgs[k];
+      const uint8_t char_class = charClass(c) & TERM_CHAR_CLASS_MASK;
+      if ((c == this->delimiter) || (char_class == CharSpace) || (char_class == CharSeparator)) {
+        isToken = false;
+      }
+      else if (isToken) {
+        if (tokens[count - 1U].len == UINT8_MAX) {
+          return InvalidArgumentLength;
+        }
+        tokens[count - 1U].len++;
+      }
+      else {
+        if (count >= max_tokens) {
+          return TooManyArguments;
+        }
+        tokens[count++] = { &this->pArgs[k], 1U };
+        isToken = true;
+      }
+    }
+    return NoError;
+  }
+
+  template <typename index_t>
+  void Command<index_t>::flushInput(void) {
+    memset(this->serialRx,  '\0', (size_t)this->bufferSize + 1U);
+    this->complete = false;
+    this->overflow = false;
+  }
+
+  template <typename index_t>
+  void Command<index_t>::flushTwoWire(void) {
+    memset(this->twowire, 0, (size_t)this->twowireSize);
+  }
+
+  template <typename index_t>
+  void Command<index_t>::initialize(void) {
+    this->index = 0U;
+    this->resetLexer();
+  }
+
+  template <typename index_t>
+  void Command<index_t>::reset(void) {
+    this->flushInput();
+    this->initialize();
+  }
+
+  template <typename index_t>
+  void Command<index_t>::resetLexer(void) {
+    this->pArgs           = nullptr;
+    this->iArgs           = 0U;
+    this->cmdStart        = 0U;
+    this->cmdLength       = 0U;
+    this->userArgsLength  = 0U;
+    this->charCount       = 0U;
+    this->twowireLength   = 0U;
+    this->readCount       = 0U;
+    this->isReadCounted   = false;
+    this->inputError        = NoError;
+    this->inputErrorIndex   = 0U;
+    this->twowireError      = NoError;
+    this->twowireErrorIndex = 0U;
+    this->flushTwoWire();
+    memset(this->prefix, '\0', sizeof(this->prefix));
+  }
+
+  template <typename index_t>
+  void Command<index_t>::lex(index_t idx) {
+    const char c = this->serialRx[idx];
+    const uint8_t char_class = charClass(c);
+
+    if ((char_class == CharInvalid) && (c != this->delimiter) && (this->inputError == NoError)) {
+      // an input buffer value was unrecognized
+      this->inputError = UnrecognizedInput;
+      this->inputErrorIndex = idx;
+    }
+
+    if ((c == this->delimiter) && (this->pArgs == nullptr) && 
+        (this->charCount != 0U) && (idx != (this->bufferSize - 1U))) {
+      // First delimiter instance is always treated as the delimiter for a user command
+      // Store pointer to next character after the delimiter to enable passing user args
+      this->pArgs = &this->serialRx[idx + 1];
+      this->iArgs = idx + 1;
+      return;
+    }
+
+    if ((char_class & TERM_CHAR_CLASS_MASK) == CharSpace) {
+      if ((this->pArgs != nullptr) && (this->iArgs == idx)) {
+        // skip leading whitespace of the user args
+        this->pArgs++;
+        this->iArgs++;
+      }
+      return;
+    }
+
+    if (this->pArgs != nullptr) {
+      // user args extend up to the last non-whitespace character
+      this->userArgsLength = idx + 1 - this->iArgs;
+    }
+    else {
+      // command extends from the first up to the last non-whitespace character
+      if (this->charCount == 0U) {
+        this->cmdStart = idx;
+      }
+      this->cmdLength = idx + 1 - this->cmdStart;
+    }
+
+    if (this->charCount < sizeof(this->prefix)) {
+      // built-in commands are case insensitive, so keep letters in lower-case
+      this->prefix[this->charCount] = ((char_class & TERM_CHAR_CLASS_MASK) >= CharLetter) ? 
+                                      (char)(c | 0x20) : c;
+    }
+    else if ((this->prefix[3] == 'd') && (this->twowireLength == 0U) && 
+             (this->charCount < (sizeof(this->prefix) + sizeof(strCmdI2CDump) - 1U)) && 
+             ((char)(c | 0x20) == (char)pgm_read_byte(&strCmdI2CDump[this->charCount - sizeof(this->prefix)]))) {
+      // 'i2c dump' may be spelled out, its letters are not part of the hex data
+    }
+    else if ((this->prefix[3] == 'r') && ((c == '#') || this->isReadCounted)) {
+      // an explicit decimal read count follows '#', e.g. 'i2c r 31 02 #64'
+      if ((char_class & TERM_CHAR_CLASS_MASK) == CharDigit) {
+        if (this->readCount < 1000U) {
+          this->readCount = (uint16_t)((this->readCount * 10U) + (char_class & TERM_CHAR_VALUE_MASK));
+        }
+      }
+      else if (((c != '#') || this->isReadCounted) && (this->twowireError == NoError)) {
+        // only digits may follow the single '#'
+        this->twowireError = InvalidTwoWireCharacter;
+        this->twowireErrorIndex = idx;
+      }
+      this->isReadCounted = true;
+    }
+    else {
+      // TwoWire hex data follows the 4 char 'i2cr', 'i2cw' or 'i2cd' command
+      if ((char_class < CharDigit) && (this->twowireError == NoError)) {
+        // an command character is invalid or unrecognized
+        this->twowireError = InvalidTwoWireCharacter;
+        this->twowireErrorIndex = idx;
+      }
+
+      // pairs of nibbles are packed into bytes, high nibble first
+      if ((this->twowireLength >> 1) < this->twowireSize) {
+        const uint8_t nibble = char_class & TERM_CHAR_VALUE_MASK;
+        if ((this->twowireLength & 1U) == 0U) {
+          this->twowire[this->twowireLength >> 1] = (uint8_t)(nibble << 4);
+        }
+        else {
+          this->twowire[this->twowireLength >> 1] |= nibble;
+        }
+        this->twowireLength++;
+      }
+      else if (this->twowireError == NoError) {
+        // the command is rejected rather than sent with its data cut short
+        this->twowireError = TwoWireDataTooLong;
+        this->twowireErrorIndex = idx;
+      }
+    }
+
+    this->charCount++;
+  }
+
+  template <typename index_t>
+  void Command<index_t>::finalize(void) {
+    if ((this->inputError == NoError) && (this->charCount == 0U)) {
+      // input serial buffer is empty
+      this->inputError = NoInput;
+    }
+  }
+
+  template <typename index_t>
+  TerminalBase<index_t>::TerminalBase(Stream* pSerial, 
+    TwoWire* pWire,
+    const char command_delimiter, 
+    char *serial_rx, 
+    const index_t buffer_size, 
+    uint8_t *twowire, 
+    const index_t twowire_size, 
+    user_callback_char_t *user_callbacks, 
+    const index_t max_user_commands, 
+    uint8_t *output_buffer, 
+    const size_t output_size) :
+    userCharCallbacks(user_callbacks), 
+    maxUserCharCallbacks(max_user_commands), 
+    termCommandDelimiter(command_delimiter), 
+    command(serial_rx, buffer_size, twowire, twowire_size, command_delimiter), 
+    output(pSerial, output_buffer, output_size) {
+    this->pSerial = pSerial;
+    this->pWire = pWire;
+  };
+
+  template <typename index_t>
+  void TerminalBase<index_t>::loop(void) {
+    this->loop(0UL);
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::loop(uint32_t budget_us) {
+    TERM_PROFILE_STAGE(loop);
+    const uint32_t start_us = micros();
+
+    if (this->scanAddress != 0U) {
+      // a running scan owns the terminal input until it completes or is cancelled
+      this->runTwoWireScan();
+    }
+
+    // a line completed during a previous call is always handled so input can't stall
+    const bool isCommandPending = this->command.complete;
+
+    while(!this->command.complete && (this->scanAddress == 0U) && (this->pSerial->available() > 0)) {
+      if ((budget_us != 0UL) && ((micros() - start_us) >= budget_us)) {
+        // yield, the rest of the input is read on the next call
+        break;
+      }
+
+      // get the new byte
+      char c = (char)this->pSerial->read();
+      TERM_PROFILE_COUNT(bytes);
+
+      // Could add handling here for ASCII '27' escape sequence indicator e.g.
+      // \033[A = VT100 Up Cursor Key      \033[B = VT100 Down Cursor Key
+      // \033[C = VT100 Right Cursor Key   \033[D = VT100 Left Cursor Key
+      if ((uint8_t)c == 8U) {
+        // ASCII character '8' is backspace
+        if (this->isEchoEnabled && (this->command.index > 0) && !this->command.overflow) {
+          // VT100 destructive backspace (delete from terminal output) is "\b \b"
+          this->output.print(F("\b \b"));
+        }
+        this->command.previous();
+      }
+      else {
+        if (this->isEchoEnabled && !this->command.overflow) {
+          this->output.print(c);
+        }
+        this->command.next(c);
+      }
+    };
+
+    // a line that arrived once the budget was spent is handled on the next call
+    const bool isBudgetSpent = (budget_us != 0UL) && ((micros() - start_us) >= budget_us);
+
+    if (this->command.complete && (isCommandPending || !isBudgetSpent)) {
+      if (this->command.overflow) {
+        // the overflowed line has now been discarded up to its line ending
+        this->lastError.set(InvalidSerialCmdLength);
+        this->lastError.printTo(this->output);
+        this->lastError.reset();
+      }
+      else {
+        TERM_PROFILE_COUNT(commands);
+        this->serialCommandProcessor();
+
+        if (this->lastError.flag) {
+          this->lastError.printTo(this->output);
+          this->lastError.reset();
+        }
+      }
+
+      // clear the input buffer array and reset serial logic
+      this->command.reset();
+      this->isNewTerminalCommandPrompt = true;
+    }
+
+    if (this->isNewTerminalCommandPrompt && (this->scanAddress == 0U)) {
+      this->isNewTerminalCommandPrompt = false;
+      this->output.print(F(">> "));
+    }
+
+    if (this->output.policy() != FlushWhenFull) {
+      this->output.flush();
+    }
+
+    const uint32_t elapsed_us = micros() - start_us;
+    if (elapsed_us > this->maxLoopDuration) {
+      this->maxLoopDuration = elapsed_us;
+    }
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::maxLoopMicros(void) const {
+    return this->maxLoopDuration;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::resetMaxLoopMicros(void) {
+    this->maxLoopDuration = 0UL;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::busy(void) const {
+    return (this->scanAddress != 0U);
+  }
+
+  #if TERM_TWOWIRE_PRESENCE_MS
+  template <typename index_t>
+  void TerminalBase<index_t>::presenceWindow(uint32_t window_ms) {
+    this->twowirePresenceWindow = window_ms;
+  }
+  #endif
+
+  template <typename index_t>
+  void TerminalBase<index_t>::twowireTimeout(uint32_t timeout_us, bool reset_with_timeout) {
+    this->twowireTimeoutMicros = timeout_us;
+    this->isTwoWireTimeoutReset = reset_with_timeout;
+  #ifdef WIRE_HAS_TIMEOUT
+    this->pWire->setWireTimeout(timeout_us, reset_with_timeout);
+  #endif
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::initialize(void) {
+    this->lastError.reset();
+    this->command.reset();
+    this->output.print(F("\n"));
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::echo(bool enable_terminal_echo) {
+    this->isEchoEnabled = enable_terminal_echo;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::abbreviate(bool enable_abbreviations) {
+    this->isAbbreviationEnabled = enable_abbreviations;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::error(error_type_t error_type) {
+    this->lastError.set(error_type);
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::outputPolicy(flush_policy_t flush_policy) {
+    this->output.policy(flush_policy);
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::flush(void) {
+    this->output.flush();
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::backpressure(backpressure_t backpressure_policy) {
+    this->output.backpressure(backpressure_policy);
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::droppedBytes(void) const {
+    return this->output.dropped();
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::resetDroppedBytes(void) {
+    this->output.resetDropped();
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::twowireDevice(uint8_t address, uint16_t delay_us, bool repeated_start) {
+    uint8_t k = 0U;
+    while ((k < this->numTwoWireDevices) && (this->twowireDevices[k].address != address)) {
+      k++;
+    }
+
+    if (k == this->numTwoWireDevices) {
+      if (k >= TERM_TWOWIRE_DEVICE_SETTINGS) {
+        return false;
+      }
+      this->numTwoWireDevices++;
+    }
+
+    this->twowireDevices[k].address = address;
+    this->twowireDevices[k].repeated_start = repeated_start;
+    this->twowireDevices[k].delay_us = delay_us;
+    return true;
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::lastTransactionMicros(void) const {
+    return this->lastTransactionDuration;
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::twowireErrors(twi_error_type_t error) const {
+    if ((error == NO_ERROR) || (error > TIME_OUT)) {
+      return 0UL;
+    }
+    return this->twowireErrorCounts[error - 1];
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::twowireRetries(void) const {
+    return this->twowireRetryCount;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::resetTwoWireErrors(void) {
+    memset(this->twowireErrorCounts, 0, sizeof(this->twowireErrorCounts));
+    this->twowireRetryCount = 0UL;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::onCommand(const char* command, user_callback_char_fn_t callback) {
+    user_callback_char_t user_callback;
+    user_callback.command = command;
+    user_callback.callback = callback;
+    user_callback.schema = nullptr;
+    user_callback.type = CharCallback;
+    this->addUserCallback(user_callback);
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::onCommand(const char* command, user_callback_argv_fn_t callback) {
+    user_callback_char_t user_callback;
+    user_callback.command = command;
+    user_callback.argv = callback;
+    user_callback.schema = nullptr;
+    user_callback.type = ArgvCallback;
+    this->addUserCallback(user_callback);
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::onCommand(const char* command, const char* schema, user_callback_args_fn_t callback) {
+    user_callback_char_t user_callback;
+    user_callback.command = command;
+    user_callback.args = callback;
+    user_callback.schema = schema;
+    user_callback.type = ArgsCallback;
+    arg_schema_t compiled;
+    if (compileSchema(schema, compiled) != NoError) {
+      return false;
+    }
+    this->addUserCallback(user_callback);
+    return true;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::addUserCallback(const user_callback_char_t &user_callback) {
+    if (this->numUserCharCallbacks >= this->maxUserCharCallbacks) {
+      // command capacity of this terminal has been reached
+      return;
+    }
+
+    // keep the table sorted by name for binary search dispatch, inserting after
+    // any equal name so that the first registration of a command is the one used
+    index_t k = this->numUserCharCallbacks;
+    while ((k > 0) && (strcmp(this->userCharCallbacks[k - 1].command, user_callback.command) > 0)) {
+      this->userCharCallbacks[k] = this->userCharCallbacks[k - 1];
+      k--;
+    }
+    this->userCharCallbacks[k] = user_callback;
+    this->numUserCharCallbacks++;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::onCommands(const user_callback_P_t *table, const index_t count) {
+    char previous[TERM_PROGMEM_COMMAND_SIZE];
+    for (index_t k = 0; (table != nullptr) && (k < count); k++) {
+      // binary search dispatch misses commands of an unsorted table or repeated names
+      if ((k > 0) && (strcmp_P(previous, table[k].command) >= 0)) {
+        return false;
+      }
+      memcpy_P(previous, table[k].command, sizeof(previous));
+
+      arg_schema_t schema;
+      if ((pgm_read_ptr(&table[k].args) != nullptr) && 
+          (compileSchema_P(table[k].schema, schema) != NoError)) {
+        return false;
+      }
+    }
+
+    this->userTableCallbacks = table;
+    this->numUserTableCallbacks = (table != nullptr) ? count : 0U;
+    return true;
+  }
+
+  #if TERM_REGISTER_CACHE_SIZE
+  template <typename index_t>
+  bool TerminalBase<index_t>::cacheRegisters(uint8_t i2c_address, uint8_t first, uint16_t count) {
+    const uint16_t last = ((first + count) < 0x100U) ? (uint16_t)(first + count) : 0x100U;
+    const size_t missing = (last - first) - this->countRegisters(i2c_address, first, last - first, 0U);
+    if ((this->numCachedRegisters + missing) > TERM_REGISTER_CACHE_SIZE) {
+      return false;
+    }
+
+    for (uint16_t reg = first; reg < last; reg++) {
+      const uint8_t k = this->findRegister(i2c_address, (uint8_t)reg);
+      if ((k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+          (this->registerCache[k].reg == reg)) {
+        continue;
+      }
+
+      // keep the cache sorted by address and register for lookups
+      for (uint8_t j = this->numCachedRegisters; j > k; j--) {
+        this->registerCache[j] = this->registerCache[j - 1];
+      }
+      this->registerCache[k].address = i2c_address;
+      this->registerCache[k].reg = (uint8_t)reg;
+      this->registerCache[k].value = 0U;
+      this->registerCache[k].flags = 0U;
+      this->numCachedRegisters++;
+    }
+    return true;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::uncacheRegisters(uint8_t i2c_address, uint8_t first, uint16_t count) {
+    uint8_t kept = 0U;
+    for (uint8_t k = 0; k < this->numCachedRegisters; k++) {
+      const twowire_register_t &entry = this->registerCache[k];
+      if ((entry.address != i2c_address) || (entry.reg < first) || (entry.reg >= (first + count))) {
+        this->registerCache[kept++] = entry;
+      }
+    }
+    this->numCachedRegisters = kept;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::invalidateRegisters(uint8_t i2c_address, uint8_t first, uint16_t count) {
+    for (uint8_t k = this->findRegister(i2c_address, first); 
+         (k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+         (this->registerCache[k].reg < (first + count)); k++) {
+      this->registerCache[k].flags = 0U;
+    }
+  }
+
+  template <typename index_t>
+  twi_error_type_t TerminalBase<index_t>::flushRegisters(void) {
+    twi_error_type_t result = NO_ERROR;
+    uint8_t burst[TERM_TWOWIRE_CHUNK_SIZE - 1U];
+
+    this->twowireRetryAddress = TwoWireNoAddress;
+    uint8_t k = 0U;
+    while (k < this->numCachedRegisters) {
+      const twowire_register_t &start = this->registerCache[k];
+      if ((start.flags & RegisterDirty) == 0U) {
+        k++;
+        continue;
+      }
+
+      // consecutive dirty registers of a device are written in a single burst
+      uint8_t size = 0U;
+      while (((k + size) < this->numCachedRegisters) && (size < sizeof(burst)) && 
+             ((this->registerCache[k + size].flags & RegisterDirty) != 0U) && 
+             (this->registerCache[k + size].address == start.address) && 
+             (this->registerCache[k + size].reg == (start.reg + size))) {
+        burst[size] = this->registerCache[k + size].value;
+        size++;
+      }
+
+      const twi_error_type_t error = this->isTwoWireAbsent(start.address) ? NACK_ADDRESS : 
+                                     this->transmitTwoWire(start.address, start.reg, burst, size, true);
+      if (error == NO_ERROR) {
+        for (uint8_t j = k; j < (k + size); j++) {
+          this->registerCache[j].flags = RegisterValid;
+        }
+      }
+      else if (result == NO_ERROR) {
+        result = error;
+      }
+      k += size;
+    }
+    return result;
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::registerCacheHits(void) const {
+    return this->registerCacheHitCount;
+  }
+
+  template <typename index_t>
+  uint32_t TerminalBase<index_t>::registerCacheMisses(void) const {
+    return this->registerCacheMissCount;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::resetRegisterCacheCounters(void) {
+    this->registerCacheHitCount = 0UL;
+    this->registerCacheMissCount = 0UL;
+  }
+
+  template <typename index_t>
+  uint8_t TerminalBase<index_t>::findRegister(uint8_t i2c_address, uint8_t i2c_register) const {
+    const uint16_t key = (uint16_t)((i2c_address << 8) | i2c_register);
+    uint8_t low = 0U;
+    uint8_t high = this->numCachedRegisters;
+    while (low < high) {
+      const uint8_t mid = (uint8_t)((low + high) >> 1);
+      const twowire_register_t &entry = this->registerCache[mid];
+      if ((uint16_t)((entry.address << 8) | entry.reg) < key) {
+        low = mid + 1U;
+      }
+      else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+
+  template <typename index_t>
+  size_t TerminalBase<index_t>::countRegisters(uint8_t i2c_address, uint8_t first, size_t count, uint8_t flags) const {
+    size_t n = 0U;
+    for (uint8_t k = this->findRegister(i2c_address, first); 
+         (k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+         ((size_t)(this->registerCache[k].reg - first) < count); k++) {
+      if ((this->registerCache[k].flags & flags) == flags) {
+        n++;
+      }
+    }
+    return n;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::storeRegisters(uint8_t i2c_address, uint8_t first, const uint8_t *data, 
+                                             size_t count, uint8_t flags) {
+    for (uint8_t k = this->findRegister(i2c_address, first); 
+         (k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+         ((size_t)(this->registerCache[k].reg - first) < count); k++) {
+      this->registerCache[k].value = data[this->registerCache[k].reg - first];
+      this->registerCache[k].flags = flags;
+    }
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::discardRegisters(uint8_t i2c_address, uint8_t first, size_t count) {
+    for (uint8_t k = this->findRegister(i2c_address, first); 
+         (k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+         ((size_t)(this->registerCache[k].reg - first) < count); k++) {
+      if ((this->registerCache[k].flags & RegisterDirty) == 0U) {
+        this->registerCache[k].flags = 0U;
+      }
+    }
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::isRegisterEntry(uint8_t k, uint8_t i2c_address, uint8_t i2c_register) const {
+    return (k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+           (this->registerCache[k].reg == i2c_register);
+  }
+  #endif
+
+  #if TERM_PROFILING
+  template <typename index_t>
+  const profile_t& TerminalBase<index_t>::profile(void) const {
+    return this->stats;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::resetProfile(void) {
+    memset(&this->stats, 0, sizeof(this->stats));
+  }
+  #endif
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::serialCommandProcessor(void) {
+    TERM_PROFILE_STAGE(serialCommandProcessor);
+
+    // check validity of incoming buffer data, already lexed on arrival
+    if (!this->isRxBufferDataValid()) {
+      return false;
+    }
+
+    // Check for user-defined functions for GPIO, configurations, reinitialization, etc.
+    if (this->runUserCallbacks()) {
+      return !this->lastError.flag;
+    }
+
+    if (this->isBuiltInCommand()) {
+      return this->runBuiltInCommand();
+    }
+
+    if (this->isAbbreviationEnabled) {
+      return this->runAbbreviatedCommand();
+    }
+
+    // no terminal commander or user-defined command was identified
+    this->lastError.set(UnrecognizedProtocol);
+    return false;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::isBuiltInCommand(void) const {
+    // built-in commands are identified by their first four non-whitespace chars
+    const char *prefix = this->command.prefix;
+    return ((prefix[0] == 'i') && (prefix[1] == '2') && (prefix[2] == 'c')) || 
+           ((prefix[0] == 's') && (prefix[1] == 'c') && (prefix[2] == 'a') && (prefix[3] == 'n'));
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::runBuiltInCommand(void) {
+    const char *prefix = this->command.prefix;
+    if ((prefix[0] == 'i') && (prefix[1] == '2') && (prefix[2] == 'c')) {
+      this->twowireRetryAddress = TwoWireNoAddress;
+      if (prefix[3] == 'r') {
+        return this->readTwoWire();
+      }
+      else if (prefix[3] == 'w') {
+        return this->writeTwoWire();
+      }
+      else if (prefix[3] == 'd') {
+        return this->dumpTwoWire();
+      }
+
+      this->lastError.set(UnrecognizedI2CTransType);
+      return false;
+    }
+    else if ((prefix[0] == 's') && (prefix[1] == 'c') && (prefix[2] == 'a') && (prefix[3] == 'n')) {
+      return this->scanTwoWireBus();
+    }
+
+    this->lastError.set(UnrecognizedProtocol);
+    return false;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::isRxBufferDataValid(void) {
+    if (this->command.inputError == NoInput) {
+      this->lastError.set(NoInput);
+      return false;
+    }
+    else if (this->command.inputError != NoError) {
+      this->lastError.set(this->command.inputError, CharPosition, this->command.inputErrorIndex + 1U);
+      return false;
+    }
+    return true;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::runUserCallbacks(void) {
+    TERM_PROFILE_STAGE(runUserCallbacks);
+
+    // Check for user-defined functions for GPIO, configurations, reinitialization, etc.
+    user_callback_char_t user_callback;
+    if (!this->findUserCallback(&this->command.serialRx[this->command.cmdStart], 
+                                this->command.cmdLength, user_callback)) {
+      return false;
+    }
+
+    this->callUserCallback(user_callback);
+    return true;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::findUserCallback(const char *span, const index_t length, 
+                                               user_callback_char_t &user_callback) {
+    // binary search for the first entry not less than the command span
+    index_t lower = 0;
+    index_t upper = this->numUserCharCallbacks;
+    while (lower < upper) {
+      const index_t middle = lower + ((upper - lower) >> 1);
+      if (compareCommand(this->userCharCallbacks[middle].command, span, length) < 0) {
+        lower = middle + 1;
+      }
+      else {
+        upper = middle;
+      }
+    }
+
+    if ((lower < this->numUserCharCallbacks) && 
+        (compareCommand(this->userCharCallbacks[lower].command, span, length) == 0)) {
+      user_callback = this->userCharCallbacks[lower];
+      return true;
+    }
+
+    // same search over the names of the PROGMEM command table
+    lower = 0;
+    upper = this->numUserTableCallbacks;
+    while (lower < upper) {
+      const index_t middle = lower + ((upper - lower) >> 1);
+      if (compareCommand_P(this->userTableCallbacks[middle].command, span, length) < 0) {
+        lower = middle + 1;
+      }
+      else {
+        upper = middle;
+      }
+    }
+
+    if ((lower < this->numUserTableCallbacks) && 
+        (compareCommand_P(this->userTableCallbacks[lower].command, span, length) == 0)) {
+      user_callback = readUserCallback_P(&this->userTableCallbacks[lower]);
+      return true;
+    }
+    return false;
   }
 
-  bool Terminal::serialCommandProcessor(void) {
-    // check validity of incoming buffer data
-    if (!this->isRxBufferDataValid()) {
+  template <typename index_t>
+  bool TerminalBase<index_t>::callUserCallback(const user_callback_char_t &user_callback) {
+    if (user_callback.callback == nullptr) {
+      // all callback types share the same pointer
+      this->lastError.set(UndefinedUserFunctionPtr);
       return false;
     }
 
-    // create a copy of the buffer without whitespace for easier parsing
-    if (!this->removeSpaces()) {
-      return false;
-    }
+    // user callbacks print directly, so staged output must go out first
+    this->output.flush();
 
-    // Check for user-defined functions for GPIO, configurations, reinitialization, etc.
-    if (this->runUserCallbacks()) {
-      return true;
-    }
+    if (user_callback.type != CharCallback) {
+      // user args are passed as spans into serialRx, nothing is copied
+      token_t tokens[TERM_MAX_ARGS];
+      uint8_t count = 0U;
+      error_type_t error = this->command.tokenize(tokens, TERM_MAX_ARGS, count);
+      if (error != NoError) {
+        this->lastError.set(error);
+        return false;
+      }
 
-    if ((this->command.data[0] == 'i' || this->command.data[0] == 'I') &&
-        (this->command.data[1] == '2') &&
-        (this->command.data[2] == 'c' || this->command.data[2] == 'C')) {
+      if (user_callback.type == ArgvCallback) {
+        user_callback.argv(tokens, count);
+        return true;
+      }
 
-      if (this->command.data[3] == 'r' || this->command.data[3] == 'R') {
-        return this->readTwoWire();
+      // the schema was validated when the command was added, and is compiled
+      // for this call only, so that no SRAM is held per command
+      arg_schema_t schema;
+      if (user_callback.type == ArgsCallback_P) {
+        compileSchema_P(user_callback.schema, schema);
       }
-      else if (this->command.data[3] == 'w' || this->command.data[3] == 'W') {
-        return this->writeTwoWire();
+      else {
+        compileSchema(user_callback.schema, schema);
       }
 
-      this->lastError.set(UnrecognizedI2CTransType);
-      return false;
+      // args are validated and converted before any user code runs
+      arg_value_t values[TERM_MAX_ARGS];
+      uint8_t failed = 0U;
+      error = parseSchemaArgs(schema, tokens, count, values, failed);
+      if ((error != NoError) && (failed < count)) {
+        this->lastError.set(error, CharPosition, 
+                            (uint16_t)(tokens[failed].ptr - this->command.serialRx) + 1U);
+        return false;
+      }
+      else if (error != NoError) {
+        this->lastError.set(error);
+        return false;
+      }
+      user_callback.args(values, count);
     }
-    else if ((this->command.data[0] == 's' || this->command.data[0] == 'S') &&
-             (this->command.data[1] == 'c' || this->command.data[1] == 'C') &&
-             (this->command.data[2] == 'a' || this->command.data[2] == 'A') &&
-             (this->command.data[3] == 'n' || this->command.data[3] == 'N')) {
-      return this->scanTwoWireBus();
+    else if (this->command.pArgs != nullptr) {
+      // user args were located and trimmed by the lexer
+      user_callback.callback(this->command.pArgs, (size_t)(this->command.userArgsLength));
     }
-
-    // no terminal commander or user-defined command was identified
-    this->lastError.set(UnrecognizedProtocol);
-    return false;
+    else {
+      user_callback.callback((char*)nullptr, (size_t)0U);
+    }
+    return true;
   }
 
-  bool Terminal::isRxBufferDataValid(void) {
-    // check validity of input command characters before parsing commands
-    uint16_t idx;
-    for (idx = 0; idx < sizeof(this->command.serialRx); idx++) {
-      // check input serial buffer only contains permitted ASCII characters
-      if (((uint8_t)this->command.serialRx[idx] > 96U) && ((uint8_t)this->command.serialRx[idx] < 122U)) {
-        // these are lower-case letters [a-z]
+  template <typename index_t>
+  bool TerminalBase<index_t>::runAbbreviatedCommand(void) {
+    const char *span = &this->command.serialRx[this->command.cmdStart];
+    const index_t length = this->command.cmdLength;
+
+    user_callback_char_t user_callback = {};
+    const char *name = nullptr;
+    const char *builtin_P = nullptr;
+    uint8_t matches = 0U;
+
+    // names sharing the prefix are next to each other in the sorted user commands
+    index_t lower = 0;
+    index_t upper = this->numUserCharCallbacks;
+    while (lower < upper) {
+      const index_t middle = lower + ((upper - lower) >> 1);
+      if (compareCommand(this->userCharCallbacks[middle].command, span, length, true) < 0) {
+        lower = middle + 1;
       }
-      else if (((uint8_t)this->command.serialRx[idx] > 47U) && ((uint8_t)this->command.serialRx[idx] < 58U)) {
-        // these are numbers [0-9]
+      else {
+        upper = middle;
       }
-      else if (((uint8_t)this->command.serialRx[idx] > 64U) && ((uint8_t)this->command.serialRx[idx] < 91U)) {
-        // these are upper-case letters [A-Z]
+    }
+    for (index_t k = lower; (k < this->numUserCharCallbacks) && (matches < 2U); k++) {
+      const char *candidate = this->userCharCallbacks[k].command;
+      if (compareCommand(candidate, span, length, true) != 0) {
+        break;
       }
-      else if (isSpace(this->command.serialRx[idx])) {
-        // this is a whitespace character which could be a delimiter
-        // isSpace() returns true for a space, form feed ('\f'), newline ('\n'), 
-        // carriage return ('\r'), horizontal tab ('\t'), or vertical tab ('\v')
+      if (name == nullptr) {
+        name = candidate;
+        user_callback = this->userCharCallbacks[k];
+        matches++;
       }
-      else if ((uint8_t)this->command.serialRx[idx] == 44U) {
-        // this is the ',' symbol which could be a delimiter
+      else if (strcmp(candidate, name) != 0) {
+        // repeated registrations of the same name are a single command
+        matches++;
       }
-      else if ((uint8_t)this->command.serialRx[idx] == 45U) {
-        // this is the '-' symbol which could be indicating a negative value
+    }
+
+    // same search over the names of the PROGMEM command table
+    lower = 0;
+    upper = this->numUserTableCallbacks;
+    while (lower < upper) {
+      const index_t middle = lower + ((upper - lower) >> 1);
+      if (compareCommand_P(this->userTableCallbacks[middle].command, span, length, true) < 0) {
+        lower = middle + 1;
       }
-      else if ((uint8_t)this->command.serialRx[idx] == 46U) {
-        // this is the '.' symbol which could be indicating a decimal value
+      else {
+        upper = middle;
       }
-      else if ((uint8_t)this->command.serialRx[idx] == 59U) {
-        // this is the ';' symbol which could be a delimiter
+    }
+    for (index_t k = lower; (k < this->numUserTableCallbacks) && (matches < 2U); k++) {
+      const char *candidate_P = this->userTableCallbacks[k].command;
+      if (compareCommand_P(candidate_P, span, length, true) != 0) {
+        break;
       }
-      else if (this->command.serialRx[idx] == this->termCommandDelimiter) {
-        // by default this is a space but can be a user-defined delimiter
+      if ((name != nullptr) && (strcmp_P(name, candidate_P) == 0)) {
+        // the table command is overloaded by a command added with onCommand()
+        continue;
       }
-      else if (this->command.serialRx[idx] == '\0') {
-        // end of serial input data has been reached
-        break;
+      if (user_callback.command == nullptr) {
+        user_callback = readUserCallback_P(&this->userTableCallbacks[k]);
       }
-      else {
-        // an input buffer value was unrecognized
-        this->lastError.set(UnrecognizedInput);
-        return false;
+      matches++;
+    }
+
+    for (uint8_t k = 0; (k < (sizeof(builtin_command_table) / sizeof(builtin_command_table[0]))) && (matches < 2U); k++) {
+      const char *candidate_P = (const char *)pgm_read_ptr(&builtin_command_table[k]);
+      if (isBuiltInPrefix(candidate_P, span, length)) {
+        builtin_P = candidate_P;
+        matches++;
       }
     }
 
-    if (idx == 0) {
-      // input serial buffer is empty
-      this->lastError.set(NoInput);
+    if (matches == 0U) {
+      this->lastError.set(UnrecognizedProtocol);
+      return false;
+    }
+    else if (matches > 1U) {
+      this->lastError.set(AmbiguousCommand);
+      return false;
+    }
+
+    if (user_callback.command != nullptr) {
+      return this->callUserCallback(user_callback);
+    }
+
+    // expand the built-in command in place, so it is lexed as if typed in full
+    if (!this->command.expand(builtin_P)) {
+      this->lastError.set(InvalidSerialCmdLength);
+      return false;
+    }
+
+    if (!this->isRxBufferDataValid()) {
+      return false;
+    }
+    return this->runBuiltInCommand();
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::parseTwoWireData(void) {
+    if (this->command.twowireError != NoError) {
+      this->lastError.set(this->command.twowireError, CharPosition, this->command.twowireErrorIndex + 1U);
+      return false;
+    }
+
+    if (this->command.twowireLength < 3) {
+      // command length does not contain an address and a register
+      this->lastError.set(InvalidTwoWireCmdLength);
+      return false;
+    }
+    else if ((this->command.twowireLength & 1U) != 0U) {
+      // command buffer does not specify hex values in multiples of 8 bits
+      this->lastError.set(InvalidHexValuePair);
       return false;
     }
 
     return true;
   }
 
-  bool Terminal::removeSpaces(void) {
-    uint8_t data_index = 0;
+  template <typename index_t>
+  twi_error_type_t TerminalBase<index_t>::transmitTwoWire(uint8_t i2c_address, uint8_t i2c_register, 
+                                                          const uint8_t *data, index_t size, bool stop) {
+    if (i2c_address != this->twowireRetryAddress) {
+      // each address of a command has its own retry budget, so a failing device
+      // can't use up the retries of the others
+      this->twowireRetryAddress = i2c_address;
+      this->twowireRetryBudget = TERM_TWOWIRE_RETRY_BUDGET;
+    }
 
-    // create a copy of the serialRx buffer with whitespace removed for easier parsing
-    for (uint8_t serialrx_index = 0; serialrx_index < TERM_CHAR_BUFFER_SIZE; serialrx_index++) {
-      if (this->command.serialRx[serialrx_index] != this->termCommandDelimiter) {
-        if (this->command.serialRx[serialrx_index] == '\0') {
-          // end of serial input data has been reached
-          if (data_index == 0U) {
-            // input serial buffer is empty
-            this->lastError.set(NoInput);
-            return false;
-          }
+    uint32_t backoff_us = TERM_TWOWIRE_BACKOFF_US;
+    uint8_t retries = 0U;
+    while (true) {
+      this->pWire->beginTransmission(i2c_address);
+      this->pWire->write(i2c_register);
+      if (size > 0U) {
+        this->pWire->write(data, size);
+      }
+      uint8_t result = this->pWire->endTransmission(stop);
+      if (result == NO_ERROR) {
+        this->setTwoWirePresence(i2c_address, NO_ERROR);
+        return NO_ERROR;
+      }
 
-          if (this->command.cmdLength == 0U) {
-            // serial buffer is not empty but command did not have any delimiter
-            this->command.cmdLength = data_index;
-          }
-          break;
-        }
-        
-        if (!isSpace(this->command.serialRx[serialrx_index])){
-          this->command.data[data_index] = this->command.serialRx[serialrx_index];
-          data_index++;
-        }
+      // some cores return codes beyond TIME_OUT for other bus errors
+      const twi_error_type_t error = (result > TIME_OUT) ? OTHER : (twi_error_type_t)result;
+      this->twowireErrorCounts[error - 1]++;
+
+      // overflows and data NACKs won't succeed by repeating the same transaction,
+      // and an address NACK is almost always an absent device
+      const bool isRetryable = (error == OTHER) || (error == TIME_OUT) || 
+                               (TERM_TWOWIRE_RETRY_ADDRESS_NACK && (error == NACK_ADDRESS));
+      if (!isRetryable || (retries >= TERM_TWOWIRE_RETRIES) || (this->twowireRetryBudget == 0U)) {
+        this->setTwoWirePresence(i2c_address, error);
+        return error;
       }
-      else {
-        if ((this->command.pArgs == nullptr) && 
-               (data_index != 0U) && 
-               (serialrx_index != (TERM_CHAR_BUFFER_SIZE - 1U))) {
-        // Store pointer to next char character after the 1st space to enable passing user args
-        this->command.pArgs = (char*)(&this->command.serialRx[serialrx_index]) + 1;
 
-        // Store index corresponding to pointer location since it is start index of user args
-        this->command.iArgs = serialrx_index;
+      retries++;
+      this->twowireRetryBudget--;
+      this->twowireRetryCount++;
+      delayMicroseconds(backoff_us);
+      backoff_us <<= 1;
+    }
+  }
 
-        // First delimiter instance is always treated as the delimiter for a user command
-        this->command.cmdLength = data_index;
-        }
-        else if (!isSpace(this->command.serialRx[serialrx_index])) {
-          this->command.data[data_index] = this->command.serialRx[serialrx_index];
-          data_index++;
-        }
-      }
+  template <typename index_t>
+  bool TerminalBase<index_t>::setTwoWireError(twi_error_type_t error, uint8_t i2c_address) {
+    this->lastError.set((error_type_t)(TwoWireTxBufferOverflow + (error - TX_BUFFER_OVERFLOW)), 
+                        TwoWireAddress, i2c_address);
+    return false;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::isTwoWireAbsent(uint8_t i2c_address) const {
+  #if TERM_TWOWIRE_PRESENCE_MS
+    const uint8_t row = (uint8_t)((i2c_address >> 3) & 0x0FU);
+    return this->isTwoWireKnown(i2c_address) && 
+           ((this->twowirePresent[row] & (1U << (i2c_address & 7U))) == 0U);
+  #else
+    (void)i2c_address;
+    return false;
+  #endif
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::setTwoWirePresence(uint8_t i2c_address, twi_error_type_t error) {
+  #if TERM_TWOWIRE_PRESENCE_MS
+    // only a scan marks an address absent, a read or write NACK may be a busy device,
+    // and the row's window isn't restarted for the other addresses of the row
+    if ((error == NO_ERROR) || (error == NACK_DATA)) {
+      this->twowirePresent[(i2c_address >> 3) & 0x0FU] |= (uint8_t)(1U << (i2c_address & 7U));
     }
-    this->command.argsLength = data_index - this->command.cmdLength;
-    return true;
+  #else
+    (void)i2c_address;
+    (void)error;
+  #endif
   }
 
-  bool Terminal::runUserCallbacks(void) {
-    // Check for user-defined functions for GPIO, configurations, reinitialization, etc.
-    if (this->command.pArgs != nullptr) {
-      char user_command[this->command.cmdLength + 1] = {'\0'};
-      memcpy(user_command, this->command.data, (size_t)(this->command.cmdLength));
-      for (uint8_t k = 0; k < this->numUserCharCallbacks; k++) {
-        if (strcmp(user_command, this->userCharCallbacks[k].command) == 0) {
-          // remove leading whitespace
-          while (*this->command.pArgs != '\0' && isSpace(this->command.pArgs[0])) {
-            this->command.pArgs++;
-            this->command.iArgs++;
-          }
+  #if TERM_TWOWIRE_PRESENCE_MS
+  template <typename index_t>
+  bool TerminalBase<index_t>::isTwoWireKnown(uint8_t i2c_address) const {
+    const uint8_t row = (uint8_t)((i2c_address >> 3) & 0x0FU);
+    return ((this->twowireKnown[row] & (1U << (i2c_address & 7U))) != 0U) && 
+           ((millis() - this->twowireRowMillis[row]) < this->twowirePresenceWindow);
+  }
 
-          // get char count for user args not including trailing whitespace/terminators
-          uint8_t user_args_length = 0;
-          for (uint8_t k = TERM_CHAR_BUFFER_SIZE; k > this->command.iArgs; k--) {
-            if ((this->command.serialRx[k] != '\0') && !isSpace(this->command.serialRx[k])) {
-              user_args_length = k - this->command.iArgs;
-              break;
-            }
-          }
+  template <typename index_t>
+  void TerminalBase<index_t>::recordTwoWireProbe(uint8_t i2c_address, twi_error_type_t error) {
+    const uint8_t row = (uint8_t)((i2c_address >> 3) & 0x0FU);
+    const uint8_t bit = (uint8_t)(1U << (i2c_address & 7U));
 
-          this->userCharCallbacks[k].callback(this->command.pArgs, (size_t)(user_args_length));
-          return true;
-        }
-      }
+    if ((millis() - this->twowireRowMillis[row]) >= this->twowirePresenceWindow) {
+      // the rest of an expired row is forgotten, the row's window restarts now
+      this->twowireKnown[row] = 0U;
+      this->twowireRowMillis[row] = millis();
+    }
+
+    if ((error == NO_ERROR) || (error == NACK_DATA)) {
+      this->twowirePresent[row] |= bit;
+      this->twowireKnown[row] |= bit;
+    }
+    else if (error == NACK_ADDRESS) {
+      this->twowirePresent[row] &= (uint8_t)~bit;
+      this->twowireKnown[row] |= bit;
     }
     else {
-      for (uint8_t k = 0; k < this->numUserCharCallbacks; k++) {
-        if (strcmp(this->command.data, this->userCharCallbacks[k].command) == 0)  {
-          this->userCharCallbacks[k].callback((char*)nullptr, (size_t)0U);
-          return true;
-        }
-      }
+      this->twowireKnown[row] &= (uint8_t)~bit;
     }
-    return false;
   }
+  #endif
+
+  template <typename index_t>
+  twi_error_type_t TerminalBase<index_t>::requestTwoWire(uint8_t i2c_address, uint8_t i2c_register, 
+                                                         uint8_t quantity) {
+    bool repeated_start = true;
+    uint16_t delay_us = 0U;
+    for (uint8_t k = 0; k < this->numTwoWireDevices; k++) {
+      if (this->twowireDevices[k].address == i2c_address) {
+        repeated_start = this->twowireDevices[k].repeated_start;
+        delay_us = this->twowireDevices[k].delay_us;
+        break;
+      }
+    }
 
-  bool Terminal::parseTwoWireData(void) {
-    // set correct length for command and args if command sent without spaces or badly formatted
-    if (this->command.cmdLength != 4U) {
-      this->command.argsLength = this->command.argsLength + this->command.cmdLength - 4U;
-      this->command.cmdLength = 4U;
+    const uint32_t start_us = micros();
+    twi_error_type_t error = this->transmitTwoWire(i2c_address, i2c_register, nullptr, 0U, !repeated_start);
+    if (error == NO_ERROR) {
+      if (delay_us > 0U) {
+        delayMicroseconds(delay_us);
+      }
+      this->pWire->requestFrom(i2c_address, quantity);
     }
-  
-    // convert buffer from from ASCII to hex and check if it contains hex value pairs
-    uint8_t idx = 0;
-    for ( ; idx < ((uint8_t)sizeof(this->command.twowire)); idx++) {
-      if (this->command.data[idx + this->command.cmdLength] == '\0') {
-        // end of serial input data has been reached
+    this->lastTransactionDuration += micros() - start_us;
+    return error;
+  }
+
+  template <typename index_t>
+  size_t TerminalBase<index_t>::readTwoWireBytes(uint8_t i2c_address, uint8_t i2c_register, 
+                                                 uint8_t *data, size_t size, twi_error_type_t &error) {
+    size_t offset = 0U;
+    error = NO_ERROR;
+    while (offset < size) {
+      const size_t remaining = size - offset;
+      const uint8_t chunk_size = (remaining < TERM_TWOWIRE_CHUNK_SIZE) ? 
+                                 (uint8_t)remaining : (uint8_t)TERM_TWOWIRE_CHUNK_SIZE;
+      error = this->requestTwoWire(i2c_address, (uint8_t)(i2c_register + offset), chunk_size);
+      if (error != NO_ERROR) {
         break;
       }
-      else {
-        this->command.twowire[idx] = (uint8_t)this->command.data[idx + this->command.cmdLength];
+
+      uint8_t received = 0U;
+      while ((received < chunk_size) && this->pWire->available()) {
+        data[offset++] = (uint8_t)this->pWire->read();
+        received++;
+      }
+      if (received < chunk_size) {
+        break;
       }
+    }
+    return offset;
+  }
 
-      if ((this->command.twowire[idx] > 96U) && (this->command.twowire[idx] < 103U)) {
-        // check for lower-case letters [a-f] and convert to upper-case
-        this->command.twowire[idx] -= 32U;
+  template <typename index_t>
+  size_t TerminalBase<index_t>::readRegisters(uint8_t i2c_address, uint8_t i2c_register, 
+                                              uint8_t *data, size_t size, twi_error_type_t &error) {
+  #if TERM_REGISTER_CACHE_SIZE
+    uint8_t k = this->findRegister(i2c_address, i2c_register);
+    size_t offset = 0U;
+    error = NO_ERROR;
+    while (offset < size) {
+      // cached entries of the range are consecutive, in register order
+      if (this->isRegisterEntry(k, i2c_address, (uint8_t)(i2c_register + offset)) && 
+          ((this->registerCache[k].flags & RegisterValid) != 0U)) {
+        data[offset++] = this->registerCache[k++].value;
+        this->registerCacheHitCount++;
+        continue;
       }
 
-      if ((this->command.twowire[idx] > 47U) && (this->command.twowire[idx] < 58U)) {
-        // check for numbers [0-9] and convert ASCII value to numeric
-        this->command.twowire[idx] -= 48U;
+      // read the following registers which can't be served in a single transaction
+      size_t run = 0U;
+      for (uint8_t j = k; (offset + run) < size; run++) {
+        if (this->isRegisterEntry(j, i2c_address, (uint8_t)(i2c_register + offset + run))) {
+          if ((this->registerCache[j].flags & RegisterValid) != 0U) {
+            break;
+          }
+          j++;
+        }
       }
-      else if ((this->command.twowire[idx] > 64U) && (this->command.twowire[idx] < 71U)) {
-          // check for upper-case letters [A-F] and convert ASCII to numeric
-          this->command.twowire[idx] -= 55U;  //subract 65, but add 10 because A == 10
+
+      const uint8_t run_register = (uint8_t)(i2c_register + offset);
+      const size_t received = this->readTwoWireBytes(i2c_address, run_register, &data[offset], run, error);
+      for (; (k < this->numCachedRegisters) && (this->registerCache[k].address == i2c_address) && 
+             ((size_t)(this->registerCache[k].reg - run_register) < received); k++) {
+        this->registerCache[k].value = data[offset + (this->registerCache[k].reg - run_register)];
+        this->registerCache[k].flags = RegisterValid;
+        this->registerCacheMissCount++;
       }
-      else {
-        // an command character is invalid or unrecognized
-        this->lastError.set(InvalidTwoWireCharacter);
-        return false;
+
+      offset += received;
+      if (received < run) {
+        break;
       }
     }
+    return offset;
+  #else
+    return this->readTwoWireBytes(i2c_address, i2c_register, data, size, error);
+  #endif
+  }
 
-    if (idx < 3) {
-      // command length does not contain an address and a register
-      this->lastError.set(InvalidTwoWireCmdLength);
-      return false;
+  template <typename index_t>
+  twi_error_type_t TerminalBase<index_t>::i2cRead(uint8_t i2c_address, uint8_t i2c_register, 
+                                                  uint8_t *data, size_t size) {
+    if (this->isTwoWireAbsent(i2c_address)) {
+      return NACK_ADDRESS;
     }
-    else if ((idx >> 1) != ((idx + 1) >> 1)) {
-      // command buffer does not specify hex values in multiples of 8 bits
-      this->lastError.set(InvalidHexValuePair);
-      return false;
+
+    this->twowireRetryAddress = TwoWireNoAddress;
+    this->lastTransactionDuration = 0UL;
+    twi_error_type_t error;
+    if ((this->readRegisters(i2c_address, i2c_register, data, size, error) < size) && (error == NO_ERROR)) {
+      error = OTHER;
     }
+    return error;
+  }
 
-    return true;
+  template <typename index_t>
+  twi_error_type_t TerminalBase<index_t>::i2cWrite(uint8_t i2c_address, uint8_t i2c_register, 
+                                                   const uint8_t *data, size_t size) {
+    if (this->isTwoWireAbsent(i2c_address)) {
+      return NACK_ADDRESS;
+    }
+
+  #if TERM_REGISTER_CACHE_SIZE
+    if ((size > 0U) && (this->countRegisters(i2c_address, i2c_register, size, 0U) == size)) {
+      // writes to cacheable registers are held back until flushRegisters()
+      this->storeRegisters(i2c_address, i2c_register, data, size, RegisterValid | RegisterDirty);
+      return NO_ERROR;
+    }
+  #endif
+
+    this->twowireRetryAddress = TwoWireNoAddress;
+    const uint32_t start_us = micros();
+    twi_error_type_t error = NO_ERROR;
+    size_t offset = 0U;
+    do {
+      // the register is the first byte of each chunk
+      const size_t remaining = size - offset;
+      const index_t chunk_size = (remaining < (TERM_TWOWIRE_CHUNK_SIZE - 1U)) ? 
+                                 (index_t)remaining : (index_t)(TERM_TWOWIRE_CHUNK_SIZE - 1U);
+      error = this->transmitTwoWire(i2c_address, (uint8_t)(i2c_register + offset), &data[offset], chunk_size, true);
+      offset += chunk_size;
+    } while ((error == NO_ERROR) && (offset < size));
+    this->lastTransactionDuration = micros() - start_us;
+
+  #if TERM_REGISTER_CACHE_SIZE
+    if (error == NO_ERROR) {
+      this->storeRegisters(i2c_address, i2c_register, data, size, RegisterValid);
+    }
+    else {
+      // cached registers of a partially written range are unknown
+      this->discardRegisters(i2c_address, i2c_register, size);
+    }
+  #endif
+    return error;
   }
 
-  bool Terminal::readTwoWire(void) {
+  template <typename index_t>
+  bool TerminalBase<index_t>::readTwoWire(void) {
     // TwoWire commands require more strict validation and parsing
     if (!this->parseTwoWireData()) {
       return false;
     }
 
-    this->pSerial->println(F("I2C Read"));
-    const uint8_t i2c_address =
-      (uint8_t)((this->command.twowire[0] << 4) + this->command.twowire[1]);
-    this->printTwoWireAddress(i2c_address);
-    const uint8_t i2c_register =
-      (uint8_t)((this->command.twowire[2] << 4) + this->command.twowire[3]);
-    this->printTwoWireRegister(i2c_register);
-    
-    uint8_t twi_read_index = 0;   // start at zero so we can use the entire buffer for read
-    this->command.flushTwoWire(); // flush the existing twowire buffer of all data
+    const uint8_t i2c_address = this->command.twowire[0];
+    const uint8_t i2c_register = this->command.twowire[1];
+    const uint16_t count = this->command.readCount;
+    if (this->command.isReadCounted && 
+        ((this->command.twowireLength != 4U) || (count == 0U) || ((i2c_register + count) > 0x100U))) {
+      // a counted read takes no dummy bytes and stays within the register range
+      this->lastError.set(InvalidTwoWireReadRange);
+      return false;
+    }
 
-    this->pWire->beginTransmission(i2c_address);
-    this->pWire->write(i2c_register);
-    twi_error_type_t error = (twi_error_type_t)(this->pWire->endTransmission());
-    if (error == NACK_ADDRESS) {
-      this->pSerial->println(F("Error: I2C read attempt recieved NACK"));
+    if (this->isTwoWireAbsent(i2c_address)) {
+      this->lastError.set(TwoWireDeviceAbsent, TwoWireAddress, i2c_address);
       return false;
     }
 
-    delayMicroseconds(50U);
-    this->pWire->requestFrom(i2c_address, (uint8_t)((this->command.argsLength >> 1) - 1));
-    delayMicroseconds(50U);
-    while(this->pWire->available()) {
-      if (twi_read_index >= TERM_TWOWIRE_BUFFER_SIZE) {
-        this->lastError.set(IncomingTwoWireReadLength);
-        return false;
+    this->output.println(F("I2C Read"));
+    this->printTwoWireAddress(i2c_address);
+    this->printTwoWireRegister(i2c_register);
+
+    this->lastTransactionDuration = 0UL;
+    if (this->command.isReadCounted) {
+      // read in chunks of the twowire buffer, each printed as it arrives
+      this->output.print(F("Read Data:"));
+      for (uint16_t offset = 0U; offset < count; ) {
+        const uint16_t remaining = (uint16_t)(count - offset);
+        const index_t size = (remaining < this->command.twowireSize) ? (index_t)remaining : this->command.twowireSize;
+        twi_error_type_t error;
+        const size_t received = this->readRegisters(i2c_address, (uint8_t)(i2c_register + offset), 
+                                                    this->command.twowire, size, error);
+        if (received > 0U) {
+          this->output.print(' ');
+          this->output.printHex(this->command.twowire, received);
+        }
+        if (received < size) {
+          this->output.print('\n');
+          if (error != NO_ERROR) {
+            return this->setTwoWireError(error, i2c_address);
+          }
+          this->lastError.set(IncompleteTwoWireRead, TwoWireAddress, i2c_address);
+          return false;
+        }
+        offset += size;
       }
-      this->command.twowire[twi_read_index] = (uint8_t)this->pWire->read();
-      twi_read_index++;
+      this->output.print('\n');
+      return true;
     }
 
-    this->pSerial->print(F("Read Data:"));
+    const uint8_t quantity = (uint8_t)((this->command.twowireLength >> 1) - 1);
+    this->command.flushTwoWire(); // flush the existing twowire buffer of all data
+
+    // start at zero so we can use the entire buffer for read
+    twi_error_type_t error;
+    const size_t twi_read_index = this->readRegisters(i2c_address, i2c_register, 
+                                                      this->command.twowire, quantity, error);
+    if (error != NO_ERROR) {
+      return this->setTwoWireError(error, i2c_address);
+    }
+
+    this->output.print(F("Read Data:"));
     if (twi_read_index == 0) {
-      this->pSerial->print(F(" No Data Received"));
+      this->output.print(F(" No Data Received"));
     }
     else {
-      for(uint8_t k = 0; k < twi_read_index; k++) {
-        if (this->command.twowire[k] < 0x10) {
-          this->pSerial->print(F(" 0x0"));
-        }
-        else {
-          this->pSerial->print(F(" 0x"));
-        }
-        this->pSerial->print(this->command.twowire[k], HEX);
-      }
+      this->output.print(' ');
+      this->output.printHex(this->command.twowire, twi_read_index);
     }
-    this->pSerial->print('\n');
+    this->output.print('\n');
     return true;
   }
 
-  bool Terminal::writeTwoWire(void) {
+  template <typename index_t>
+  bool TerminalBase<index_t>::writeTwoWire(void) {
     // TwoWire commands require more strict validation and parsing
     if (!this->parseTwoWireData()) {
       return false;
     }
 
-    if (command.argsLength < 6U) {
+    if (this->command.twowireLength < 6U) {
       this->lastError.set(InvalidTwoWireWriteData);
       return false;
     }
 
-    this->pSerial->println(F("I2C Write"));
-    const uint8_t i2c_address =
-      (uint8_t)((this->command.twowire[0] << 4) + this->command.twowire[1]);
+    const uint8_t i2c_address = this->command.twowire[0];
+    if (this->isTwoWireAbsent(i2c_address)) {
+      this->lastError.set(TwoWireDeviceAbsent, TwoWireAddress, i2c_address);
+      return false;
+    }
+
+    this->output.println(F("I2C Write"));
     this->printTwoWireAddress(i2c_address);
-    const uint8_t i2c_register =
-      (uint8_t)((this->command.twowire[2] << 4) + this->command.twowire[3]);
+    const uint8_t i2c_register = this->command.twowire[1];
     this->printTwoWireRegister(i2c_register);
 
-    this->pWire->beginTransmission(i2c_address);
-    this->pWire->write(i2c_register);
-    for (uint8_t k = 4; k < this->command.argsLength; k += 2) {
-      this->pWire->write((16 * this->command.twowire[k]) + this->command.twowire[k+1]);
+    // the write data follows the address and register bytes
+    const uint8_t *write_data = &this->command.twowire[2];
+    const index_t write_size = (index_t)((this->command.twowireLength >> 1) - 2U);
+
+    const uint32_t start_us = micros();
+    twi_error_type_t error = this->transmitTwoWire(i2c_address, i2c_register, write_data, write_size, true);
+    this->lastTransactionDuration = micros() - start_us;
+
+  #if TERM_REGISTER_CACHE_SIZE
+    // the device now holds the written values, or unknown values after a failure
+    if (error == NO_ERROR) {
+      this->storeRegisters(i2c_address, i2c_register, write_data, write_size, RegisterValid);
+    }
+    else {
+      this->discardRegisters(i2c_address, i2c_register, write_size);
+    }
+  #endif
+
+    if (error != NO_ERROR) {
+      return this->setTwoWireError(error, i2c_address);
+    }
+
+    this->output.print(F("Write Data: "));
+    this->output.printHex(write_data, write_size);
+    this->output.print('\n');
+    return true;
+  }
+
+  template <typename index_t>
+  bool TerminalBase<index_t>::dumpTwoWire(void) {
+    if (this->command.twowireError != NoError) {
+      this->lastError.set(this->command.twowireError, CharPosition, this->command.twowireErrorIndex + 1U);
+      return false;
+    }
+
+    // two nibbles each of address and register, followed by 1 to 3 nibbles of count
+    if ((this->command.twowireLength < 5U) || (this->command.twowireLength > 7U)) {
+      this->lastError.set(InvalidTwoWireReadRange);
+      return false;
+    }
+
+    const uint8_t i2c_address = this->command.twowire[0];
+    const uint8_t i2c_register = this->command.twowire[1];
+    uint16_t count = 0U;
+    for (index_t k = 4; k < this->command.twowireLength; k++) {
+      const uint8_t packed = this->command.twowire[k >> 1];
+      count = (uint16_t)((count << 4) + (((k & 1U) == 0U) ? (packed >> 4) : (packed & 0x0FU)));
+    }
+
+    if ((count == 0U) || ((i2c_register + count) > 0x100U)) {
+      this->lastError.set(InvalidTwoWireReadRange);
+      return false;
     }
-    twi_error_type_t error = (twi_error_type_t)(this->pWire->endTransmission());
-    if (error == NACK_ADDRESS) {
-      this->pSerial->println(F("Error: I2C write attempt recieved NACK"));
+
+    if (this->isTwoWireAbsent(i2c_address)) {
+      this->lastError.set(TwoWireDeviceAbsent, TwoWireAddress, i2c_address);
       return false;
     }
 
-    this->pSerial->print(F("Write Data:"));
-    for(uint8_t k = 4; k < this->command.argsLength; k += 2) {
-      uint8_t write_data = (16 * this->command.twowire[k]) + this->command.twowire[k+1];
-      if (write_data < 0x01) {
-        this->pSerial->print(F(" 0x0"));
+    this->output.println(F("I2C Dump"));
+    this->printTwoWireAddress(i2c_address);
+    this->printTwoWireRegister(i2c_register);
+
+    // a single line is buffered, chunks are streamed to the output as they arrive
+    uint8_t line[TERM_HEXDUMP_LINE_SIZE];
+    uint8_t line_size = 0U;
+    uint8_t line_register = i2c_register;
+    uint16_t offset = 0U;
+
+    this->lastTransactionDuration = 0UL;
+    while (offset < count) {
+      const uint16_t remaining = (uint16_t)(count - offset);
+      const uint8_t chunk_register = (uint8_t)(i2c_register + offset);
+      const uint8_t chunk_size = (remaining < TERM_TWOWIRE_CHUNK_SIZE) ? 
+                                 (uint8_t)remaining : (uint8_t)TERM_TWOWIRE_CHUNK_SIZE;
+
+      twi_error_type_t error = this->requestTwoWire(i2c_address, chunk_register, chunk_size);
+      if (error != NO_ERROR) {
+        // print the bytes of the chunks which did succeed before reporting the error
+        if (line_size > 0U) {
+          this->printHexdumpLine(line_register, line, line_size);
+        }
+        return this->setTwoWireError(error, i2c_address);
       }
-      else {
-        this->pSerial->print(F(" 0x"));
+
+      uint8_t received = 0U;
+      while ((received < chunk_size) && this->pWire->available()) {
+        line[line_size++] = (uint8_t)this->pWire->read();
+        received++;
+        if (line_size == TERM_HEXDUMP_LINE_SIZE) {
+          this->printHexdumpLine(line_register, line, line_size);
+          line_register = (uint8_t)(line_register + line_size);
+          line_size = 0U;
+        }
+      }
+      offset += received;
+
+      if (received < chunk_size) {
+        // print the bytes which did arrive before reporting the short read
+        if (line_size > 0U) {
+          this->printHexdumpLine(line_register, line, line_size);
+        }
+        this->lastError.set(IncompleteTwoWireRead, TwoWireAddress, i2c_address);
+        return false;
       }
-      this->pSerial->print(write_data, HEX);
     }
-    this->pSerial->print('\n');
+
+    if (line_size > 0U) {
+      this->printHexdumpLine(line_register, line, line_size);
+    }
     return true;
   }
 
-  bool Terminal::scanTwoWireBus(void) {
-    // This command does not accept additional arguments
-    if ((this->command.argsLength + this->command.cmdLength) > 4U) {
-      /** TODO: this could be a warning instead of an error */
-      this->lastError.set(UnrecognizedProtocol);
-      return false;
+  template <typename index_t>
+  void TerminalBase<index_t>::printHexdumpLine(uint8_t i2c_register, const uint8_t *data, uint8_t size) {
+    this->output.printHex(&i2c_register, 1U, HexSpaced);
+    this->output.print(F(": "));
+    this->output.printHex(data, size, HexSpaced);
+
+    // pad a short last line so its ASCII column lines up with the others
+    for (uint8_t k = size; k < TERM_HEXDUMP_LINE_SIZE; k++) {
+      this->output.print(F("   "));
     }
 
-    this->pSerial->println(F("Scanning for available I2C devices..."));
+    this->output.print(F("  |"));
+    for (uint8_t k = 0; k < size; k++) {
+      this->output.print(((data[k] >= 0x20U) && (data[k] < 0x7FU)) ? (char)data[k] : '.');
+    }
+    this->output.print(F("|\n"));
+  }
 
-    twi_error_type_t error;
-    uint8_t device_count = 0;
+  template <typename index_t>
+  bool TerminalBase<index_t>::scanTwoWireBus(void) {
+    // This command accepts no argument other than '--delta'
+    bool is_delta = false;
+    if (this->command.charCount > 4U) {
+      const index_t delta_length = (index_t)(sizeof(strCmdScanDelta) - 1U);
+      is_delta = (this->command.pArgs != nullptr) && (this->command.userArgsLength == delta_length);
+      for (index_t k = 0; is_delta && (k < delta_length); k++) {
+        is_delta = ((char)(this->command.pArgs[k] | 0x20) == (char)pgm_read_byte(&strCmdScanDelta[k]));
+      }
+
+      if (!is_delta || ((this->command.charCount - 4U) != delta_length) || !TERM_TWOWIRE_PRESENCE_MS) {
+        // a delta scan needs the presence cache
+        /** TODO: this could be a warning instead of an error */
+        this->lastError.set(UnrecognizedProtocol);
+        return false;
+      }
+    }
+
+    if (is_delta) {
+      this->output.println(F("Scanning for changed I2C devices..."));
+    }
+    else {
+      this->output.println(F("Scanning for available I2C devices..."));
+    }
+
+    this->scanAddress = 1U;
+    this->scanDeviceCount = 0U;
+    this->isScanDelta = is_delta;
+    this->lastTransactionDuration = 0UL;
+    return true;
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::runTwoWireScan(void) {
+    if (this->pSerial->available() > 0) {
+      // any input cancels the scan, an empty line is consumed as the cancel key
+      // and anything else is kept for the lexer, e.g. a command sent after 'scan'
+      while ((this->pSerial->available() > 0) && 
+             ((this->pSerial->peek() == ' ') || (this->pSerial->peek() == '\r'))) {
+        this->pSerial->read();
+      }
+      if (this->pSerial->peek() == TERM_LINE_ENDING) {
+        this->pSerial->read();
+      }
+      this->output.println(F("Scan cancelled"));
+      this->scanAddress = 0U;
+
+      // prompt before the input which cancelled the scan is read
+      this->isNewTerminalCommandPrompt = false;
+      this->output.print(F(">> "));
+      return;
+    }
+
+  #ifdef WIRE_HAS_TIMEOUT
+    // probe with a short timeout, but only for as long as this call probes, so
+    // the sketch's own use of Wire in between runs with its own timeout
+    this->pWire->setWireTimeout(TERM_SCAN_TIMEOUT_US, true);
+  #endif
+
+    uint8_t probes = 0U;
+    while ((probes < TERM_SCAN_PROBES_PER_LOOP) && (this->scanAddress <= 127U)) {
+      const uint8_t address = this->scanAddress++;
+    #if TERM_TWOWIRE_PRESENCE_MS
+      const uint8_t row = (uint8_t)(address >> 3);
+      const uint8_t bit = (uint8_t)(1U << (address & 7U));
+
+      if (this->isScanDelta) {
+        if (this->isTwoWireKnown(address)) {
+          // a recent presence is trusted without a probe
+          continue;
+        }
+      }
+      else if (((address & 7U) == 0U) || (address == 1U)) {
+        // a full scan observes each row anew
+        this->twowireKnown[row] = 0U;
+        this->twowireRowMillis[row] = millis();
+      }
+
+      const bool was_present = ((this->twowirePresent[row] & bit) != 0U);
+    #else
+      const bool was_present = false;
+    #endif
+      probes++;
 
-    for(uint8_t address = 1; address <= 127; address++ ) {
       // This uses the return value of Write.endTransmisstion to
       // see if a device acknowledgement occured at the address.
+      const uint32_t start_us = micros();
       this->pWire->beginTransmission(address);
-      error = (twi_error_type_t)(this->pWire->endTransmission());
-
-      if (error == NO_ERROR) {
-        this->pSerial->print(F("I2C device found at "));
+      const uint8_t result = this->pWire->endTransmission();
+      this->lastTransactionDuration += micros() - start_us;
+      const twi_error_type_t error = (result > TIME_OUT) ? OTHER : (twi_error_type_t)result;
+    #if TERM_TWOWIRE_PRESENCE_MS
+      this->recordTwoWireProbe(address, error);
+    #endif
+
+      if (this->isScanDelta) {
+        if ((error == NO_ERROR) && !was_present) {
+          this->output.print(F("I2C device appeared at "));
+          this->printTwoWireAddress(address);
+          this->scanDeviceCount++;
+        }
+        else if ((error == NACK_ADDRESS) && was_present) {
+          this->output.print(F("I2C device disappeared at "));
+          this->printTwoWireAddress(address);
+          this->scanDeviceCount++;
+        }
+      }
+      else if (error == NO_ERROR) {
+        this->output.print(F("I2C device found at "));
+        this->printTwoWireAddress(address);
+        this->scanDeviceCount++;
+      }
+      else if (error == TIME_OUT) {
+        this->twowireErrorCounts[error - 1]++;
+        this->output.print(F("Timeout at "));
         this->printTwoWireAddress(address);
-        device_count++;
+      #ifdef WIRE_HAS_TIMEOUT
+        this->pWire->clearWireTimeoutFlag();
+      #endif
       }
-      else if (error == OTHER) {
-        this->pSerial->print(F("Unknown error at "));
+      else if (error != NACK_ADDRESS) {
+        this->twowireErrorCounts[error - 1]++;
+        this->output.print(F("Unknown error at "));
         this->printTwoWireAddress(address);
       }
     }
 
-    if (device_count == 0) {
-      pSerial->println(F("No I2C devices found :("));
-    }
-    else {
-      pSerial->print(F("Scan complete, "));
-      pSerial->print(device_count);
-      pSerial->println(F(" devices found!"));
+  #ifdef WIRE_HAS_TIMEOUT
+    this->pWire->setWireTimeout(this->twowireTimeoutMicros, this->isTwoWireTimeoutReset);
+  #endif
+
+    if (this->scanAddress <= 127U) {
+      return;
     }
-    return true;
-  }
 
-  void Terminal::printTwoWireAddress(uint8_t i2c_address) {
-    if (i2c_address < 0x10) {
-      this->pSerial->print(F("Address: 0x0"));
+    if (this->isScanDelta) {
+      this->output.print(F("Scan complete, "));
+      this->output.print(this->scanDeviceCount);
+      this->output.println(F(" devices changed"));
+    }
+    else if (this->scanDeviceCount == 0) {
+      this->output.println(F("No I2C devices found :("));
     }
     else {
-      this->pSerial->print(F("Address: 0x"));
+      this->output.print(F("Scan complete, "));
+      this->output.print(this->scanDeviceCount);
+      this->output.println(F(" devices found!"));
     }
-    this->pSerial->println(i2c_address, HEX);
+    this->scanAddress = 0U;
   }
 
-  void Terminal::printTwoWireRegister(uint8_t i2c_register) {
-    if (i2c_register < 0x10) {
-      this->pSerial->print(F("Register: 0x0"));
-    }
-    else {
-      this->pSerial->print(F("Register: 0x"));
-    }
-    this->pSerial->println(i2c_register, HEX);
+  template <typename index_t>
+  void TerminalBase<index_t>::printTwoWireAddress(uint8_t i2c_address) {
+    this->output.print(F("Address: "));
+    this->output.printHex(&i2c_address, 1U);
+    this->output.println();
+  }
+
+  template <typename index_t>
+  void TerminalBase<index_t>::printTwoWireRegister(uint8_t i2c_register) {
+    this->output.print(F("Register: "));
+    this->output.printHex(&i2c_register, 1U);
+    this->output.println();
   }
+
+  // terminals index with either uint8_t or uint16_t, see index_type
+  template class Command<uint8_t>;
+  template class Command<uint16_t>;
+  template class TerminalBase<uint8_t>;
+  template class TerminalBase<uint16_t>;
 }
@@ -14,19 +14,116 @@
   #define TERM_LINE_ENDING            ('\n')
   #define TERM_DEFAULT_CMD_DELIMITER  ( ' ')
 
-  // UART TERM console input, I2C, and 'error' buffer sizes
+  // UART TERM console input and I2C buffer sizes of the default Terminal,
+  // use BasicTerminal to size individual terminals without changing these defaults
   #define TERM_CHAR_BUFFER_SIZE       ( 64U)  // terminal buffer length in bytes
   #define TERM_TWOWIRE_BUFFER_SIZE    ( 30U)  // TwoWire read/write buffer length
-  #define TERM_ERROR_MESSAGE_SIZE     ( 64U)  // error message buffer length
-  #define TERM_MICROSEC_PER_CHAR      (140U)  // assumes 57600 baud minimum
 
-  // Maximum number of unique user-defined commands
+  // Maximum number of unique user-defined commands of the default Terminal
   #define MAX_USER_COMMANDS           ( 10U)
 
+  // Output staging buffer size of the default Terminal, responses are written in
+  // chunks of up to this many bytes
+  #define TERM_OUTPUT_BUFFER_SIZE     ( 64U)
+
+  // Command name size of a PROGMEM command table entry, including the '\0'
+  #ifndef TERM_PROGMEM_COMMAND_SIZE
+    #define TERM_PROGMEM_COMMAND_SIZE ( 12U)
+  #endif
+
+  // Argument schema size of a PROGMEM command table entry, including the '\0'
+  #ifndef TERM_PROGMEM_SCHEMA_SIZE
+    #define TERM_PROGMEM_SCHEMA_SIZE  ( 24U)
+  #endif
+
+  // Maximum number of argument tokens passed to a user argv callback
+  #ifndef TERM_MAX_ARGS
+    #define TERM_MAX_ARGS             (  8U)
+  #endif
+
+  #if (TERM_MAX_ARGS > 255U)
+    #error "TERM_MAX_ARGS must not exceed 255"
+  #endif
+
+  // Bytes per I2C transaction of 'i2c dump', counted 'i2c r' and i2cRead()/i2cWrite(),
+  // a write chunk includes the register byte
+  #ifndef TERM_TWOWIRE_CHUNK_SIZE
+    #define TERM_TWOWIRE_CHUNK_SIZE   ( 32U)
+  #endif
+
+  #if (TERM_TWOWIRE_CHUNK_SIZE < 2U) || (TERM_TWOWIRE_CHUNK_SIZE > 255U)
+    #error "TERM_TWOWIRE_CHUNK_SIZE must be between 2 and 255"
+  #elif (TERM_TWOWIRE_CHUNK_SIZE > 32U)
+    #warning "Wire library does not support transactions exceeding 32 bytes"
+  #endif
+
+  // Number of I2C devices with individual settings, see Terminal::twowireDevice()
+  #ifndef TERM_TWOWIRE_DEVICE_SETTINGS
+    #define TERM_TWOWIRE_DEVICE_SETTINGS  (4U)
+  #endif
+
+  // Time in milliseconds for which TxBlock output waits on a Stream which accepts
+  // no bytes at all, e.g. a disconnected USB serial port, before output is dropped
+  #ifndef TERM_TX_BLOCK_TIMEOUT_MS
+    #define TERM_TX_BLOCK_TIMEOUT_MS  (1000UL)
+  #endif
+
+  // Retries of a failed I2C transaction, each after twice the previous backoff
+  #ifndef TERM_TWOWIRE_RETRIES
+    #define TERM_TWOWIRE_RETRIES      (  2U)
+  #endif
+
+  // Backoff before the first retry of a failed I2C transaction in microseconds
+  #ifndef TERM_TWOWIRE_BACKOFF_US
+    #define TERM_TWOWIRE_BACKOFF_US   ( 50U)
+  #endif
+
+  // Maximum number of I2C retries per device address of a single built-in command
+  #ifndef TERM_TWOWIRE_RETRY_BUDGET
+    #define TERM_TWOWIRE_RETRY_BUDGET (  8U)
+  #endif
+
+  // Set to 1 to retry I2C address NACKs too, for devices which don't acknowledge
+  // while busy, e.g. an EEPROM during its write cycle
+  #ifndef TERM_TWOWIRE_RETRY_ADDRESS_NACK
+    #define TERM_TWOWIRE_RETRY_ADDRESS_NACK (0)
+  #endif
+
+  // Number of I2C addresses probed by 'scan' per loop() call
+  #ifndef TERM_SCAN_PROBES_PER_LOOP
+    #define TERM_SCAN_PROBES_PER_LOOP (  8U)
+  #endif
+
+  // Timeout of a single 'scan' probe in microseconds, for Wire libraries with setWireTimeout()
+  #ifndef TERM_SCAN_TIMEOUT_US
+    #define TERM_SCAN_TIMEOUT_US      (2000UL)
+  #endif
+
+  // Time in milliseconds for which an I2C device presence observed by 'scan' is
+  // trusted, 0 compiles the presence cache out (see Terminal::presenceWindow())
+  #ifndef TERM_TWOWIRE_PRESENCE_MS
+    #define TERM_TWOWIRE_PRESENCE_MS  (   0UL)
+  #endif
+
+  // Number of I2C registers the shadow cache can hold, 0 compiles the cache out
+  // (see Terminal::cacheRegisters())
+  #ifndef TERM_REGISTER_CACHE_SIZE
+    #define TERM_REGISTER_CACHE_SIZE  (  0U)
+  #endif
+
+  #if (TERM_REGISTER_CACHE_SIZE > 255U)
+    #error "TERM_REGISTER_CACHE_SIZE must not exceed 255"
+  #endif
+
+  // Set to 1 to compile per-stage timing counters into Terminal (see Terminal::profile())
+  #ifndef TERM_PROFILING
+    #define TERM_PROFILING            (  0)
+  #endif
+
   #if (TERM_TWOWIRE_BUFFER_SIZE > TERM_CHAR_BUFFER_SIZE)
     #error "TwoWire buffer size must not exceed terminal character buffer size"
-  #elif (TERM_TWOWIRE_BUFFER_SIZE > 34U)
-    // '34' since this buffer size includes address and register bytes
+  #elif (TERM_TWOWIRE_BUFFER_SIZE > 33U)
+    // '33' since this buffer size includes the address byte, which is not sent as data
     #warning "Wire library does not support transactions exceeding 32 bytes"
   #endif
 
@@ -55,17 +152,146 @@
       // e.g. [&](){}, but requires #include <functional> which is not supported for AVR cores
       // typedef std::function<void(char*, size_t)> user_callback_char_fn_t
 
+      /**
+       * @struct token_t "terminal_commander.h"
+       * @brief Span of a single user argument in the serial rx buffer
+       *
+       * @details Tokens point into the terminal's own buffer and are not
+       *          null-terminated, use len to bound any access. They are only
+       *          valid for the duration of the callback.
+       */
+      struct token_t {
+        const char *ptr;
+        uint8_t len;
+      };
+
+      /** @brief User argv callback receiving the user args split into tokens */
+      typedef void (user_callback_argv_fn_t)(const token_t*, uint8_t);
+
+      /**
+       * @union arg_value_t "terminal_commander.h"
+       * @brief Value of a single user argument converted according to a schema
+       *
+       * @details Integer schema types ('i8', 'i16', 'i32' and 'fixN') are held in i,
+       *          unsigned types ('u8', 'u16', 'u32' and 'hex') in u, 'float' in f
+       *          and 'str' in s.
+       */
+      union arg_value_t {
+        int32_t i;
+        uint32_t u;
+        float f;
+        token_t s;
+      };
+
+      /** @brief User args callback receiving the user args converted by a schema */
+      typedef void (user_callback_args_fn_t)(const arg_value_t*, uint8_t);
+
+      /** @brief Signature of the callback held by a user_callback_char_t */
+      enum user_callback_type_t : uint8_t {
+        CharCallback = 0, 
+        ArgvCallback, 
+        ArgsCallback, 
+        ArgsCallback_P,     // args callback of a command table, its schema is in PROGMEM
+      };
+
+      /**
+       * @struct arg_schema_t "terminal_commander.h"
+       * @brief Argument schema of an args callback, compiled from its text form
+       *
+       * @details Validated when the command is added and compiled on the stack
+       *          each time the command is run, so no SRAM is held per command.
+       *          Optional args follow all required args, and only the last
+       *          type code may be marked as repeated.
+       */
+      struct arg_schema_t {
+        uint8_t types[TERM_MAX_ARGS];   // type code of each arg
+        uint8_t count;                  // number of type codes
+        uint8_t required;               // number of leading required args
+      };
+
       /**
        * @struct user_callback_char_t "terminal_commander.h"
        * @brief Use this struct to hold user commands and callback fn
        *
        * @details This struct holds a single user command (as created by
        *          Terminal::onCommand() for a callback function 
-       *          matching the type user_callback_char_fn_t
+       *          matching the type user_callback_char_fn_t, user_callback_argv_fn_t
+       *          or user_callback_args_fn_t, as selected by type. The schema text
+       *          is only used by args callbacks.
        */
       struct user_callback_char_t {
         const char *command;
+        union {
+          user_callback_char_fn_t *callback;
+          user_callback_argv_fn_t *argv;
+          user_callback_args_fn_t *args;
+        };
+        const char *schema;
+        user_callback_type_t type;
+      };
+
+      /**
+       * @struct user_callback_P_t "terminal_commander.h"
+       * @brief Entry of a user command table stored in PROGMEM
+       *
+       * @details The command name and schema are held in the entry itself, so
+       *          that a table declared constexpr and PROGMEM keeps names, schemas
+       *          and callbacks in flash. Tables are registered with
+       *          Terminal::onCommands() and must be sorted by name, which can be
+       *          checked at compile time with isCommandTableSorted(). Only one
+       *          callback of an entry is set, e.g. { "set", nullptr, &set_argv }
+       *          for an argv callback or { "pwm", nullptr, nullptr, "u8 u16",
+       *          &pwm_args } for an args callback with its schema.
+       */
+      struct user_callback_P_t {
+        char command[TERM_PROGMEM_COMMAND_SIZE];
         user_callback_char_fn_t *callback;
+        user_callback_argv_fn_t *argv;
+        char schema[TERM_PROGMEM_SCHEMA_SIZE];
+        user_callback_args_fn_t *args;
+      };
+
+      /** @brief Compile-time strcmp() of two command names */
+      constexpr int compareCommandName(const char *s1, const char *s2) {
+        return ((*s1 != *s2) || (*s1 == '\0')) ? 
+               ((int)(uint8_t)*s1 - (int)(uint8_t)*s2) : 
+               compareCommandName(s1 + 1, s2 + 1);
+      }
+
+      /**
+       * @brief Check at compile time that a command table is sorted and unique
+       *
+       * @details Usage:
+       *            static_assert(isCommandTableSorted(my_commands), "unsorted commands");
+       *
+       * @param   user_callback_P_t[] constexpr command table
+       * @returns bool  True if all names are in strictly ascending strcmp() order
+       */
+      template <size_t N>
+      constexpr bool isCommandTableSorted(const user_callback_P_t (&table)[N], size_t k = 1U) {
+        return (k >= N) ? true : 
+               ((compareCommandName(table[k - 1U].command, table[k].command) < 0) && 
+                isCommandTableSorted(table, k + 1U));
+      }
+
+      /** @brief When the terminal output staging buffer is written to the Stream */
+      enum flush_policy_t : uint8_t {
+        FlushPerLine = 0,   // after every '\n'
+        FlushPerResponse,   // once per loop() call, after the response and prompt
+        FlushWhenFull,      // only when the buffer is full or on Terminal::flush()
+      };
+
+      /** @brief Layout of byte arrays printed by Output::printHex() */
+      enum hex_format_t : uint8_t {
+        HexPrefixed = 0,    // "0x0A 0x1B 0x2C"
+        HexSpaced,          // "0A 1B 2C"
+      };
+
+      /** @brief What the terminal output does when its buffer is full */
+      enum backpressure_t : uint8_t {
+        TxBlock = 0,        // wait for the Stream to accept all staged output
+        TxDrop,             // drop bytes which don't fit
+        TxTruncate,         // drop the rest of a line which doesn't fit
       };
 
       /** @brief Index of the string error table array */
@@ -82,6 +308,101 @@
         InvalidHexValuePair, 
         UnrecognizedProtocol, 
         UnrecognizedI2CTransType, 
+        AmbiguousCommand, 
+        TooManyArguments, 
+        InvalidArgumentLength, 
+        InvalidNumber, 
+        NumberOutOfRange, 
+        MissingArgument, 
+        InvalidArgumentSchema, 
+        InvalidTwoWireReadRange, 
+        IncompleteTwoWireRead, 
+        TwoWireDataTooLong, 
+        TwoWireTxBufferOverflow,  // TwoWire errors in the order of twi_error_type_t
+        TwoWireNackAddress, 
+        TwoWireNackData, 
+        TwoWireBusError, 
+        TwoWireTimeout, 
+        TwoWireDeviceAbsent, 
+      };
+
+      /** @brief Meaning of the optional context value of an error */
+      enum error_context_t {
+        NoContext = 0,
+        CharPosition, 
+        TwoWireAddress, 
+      };
+
+      /**
+       * @struct profile_stage_t "terminal_commander.h"
+       * @brief Accumulated timing of a single terminal processing stage
+       *
+       * @details Durations are measured with micros(), so resolution is
+       *          limited to that of the core (4 us on 16 MHz AVR).
+       */
+      struct profile_stage_t {
+        uint32_t calls;
+        uint32_t total_us;
+        uint32_t max_us;
+      };
+
+      /**
+       * @struct profile_t "terminal_commander.h"
+       * @brief Terminal throughput counters and per-stage timing
+       *
+       * @details Only maintained when TERM_PROFILING is set to 1. Throughput
+       *          (commands/s, bytes/s) is derived by dividing the counters by
+       *          the wall-clock time over which they were collected.
+       */
+      struct profile_t {
+        uint32_t commands;
+        uint32_t bytes;
+        profile_stage_t loop;
+        profile_stage_t serialCommandProcessor;
+        profile_stage_t runUserCallbacks;
+      };
+
+      /**
+       * @struct index_type "terminal_commander.h"
+       * @brief Selects the narrowest unsigned type able to index a terminal
+       *
+       * @details Terminals with buffers and command tables of at most 255
+       *          elements use uint8_t indicies, larger terminals use uint16_t.
+       */
+      template <bool isWide> struct index_type { typedef uint8_t type; };
+      template <> struct index_type<true> { typedef uint16_t type; };
+
+      /**
+       * @struct twowire_device_t "terminal_commander.h"
+       * @brief I2C transaction settings of a single device
+       *
+       * @details Devices without settings are read with a repeated start and
+       *          without a delay between the register write and the read.
+       */
+      struct twowire_device_t {
+        uint8_t address;
+        bool repeated_start;
+        uint16_t delay_us;
+      };
+
+      /** @brief State flags of a register in the shadow cache */
+      enum register_flags_t : uint8_t {
+        RegisterValid = 0x01U,  // value matches or is pending for the device
+        RegisterDirty = 0x02U,  // value is pending, written by flushRegisters()
+      };
+
+      /**
+       * @struct twowire_register_t "terminal_commander.h"
+       * @brief Shadow cache entry of a single I2C register
+       *
+       * @details Entries are kept sorted by address and register, a register
+       *          without an entry is not cached.
+       */
+      struct twowire_register_t {
+        uint8_t address;
+        uint8_t reg;
+        uint8_t value;
+        uint8_t flags;
       };
 
       /** @brief Error names returned by Wire.endTransmission() */
@@ -98,6 +419,9 @@
     /**
      * @class Error "terminal_commander.h"
      * @brief Terminal Commander error states and messages
+     *
+     * @details Error messages are never copied to SRAM, they are printed
+     *          directly from the PROGMEM string_error_table using the type.
      */
     class Error {
       public:
@@ -110,8 +434,11 @@
         /** Enum indexing the string_error_table array */
         TerminalCommanderTypes::error_type_t type;
 
-        /** Char array for holding the terminal error message */
-        char message[TERM_ERROR_MESSAGE_SIZE + 1] = {'\0'};
+        /** Meaning of the context value, NoContext if there is none */
+        TerminalCommanderTypes::error_context_t contextType;
+
+        /** Optional context of the error, e.g. offending char position or I2C address */
+        uint16_t context;
 
         /*! @brief Construct an instance of the Error class
         *
@@ -120,25 +447,34 @@
         Error(void);
 
         /**
-         * @brief Set a new error message and raise the error flag
+         * @brief Set a new error type and raise the error flag
          *
-         * @details Set with set the error message using the string_error_table
+         * @details Set will select the error message from the string_error_table
          *          and will flag that an error has occured by setting flag = true.
+         *          Optionally, a context value is stored for printing with the message.
          * 
-         * @param   error_type_t TerminalCommanderTypes::error_type_t
+         * @param   error_type_t    TerminalCommanderTypes::error_type_t
+         * @param   error_context_t Meaning of the context value, or NoContext
+         * @param   uint16_t        Context value, e.g. a char position or I2C address
          * @returns void
          */
-        void set(TerminalCommanderTypes::error_type_t error_type);
+        void set(TerminalCommanderTypes::error_type_t error_type, 
+                 TerminalCommanderTypes::error_context_t context_type = TerminalCommanderTypes::NoContext, 
+                 uint16_t context = 0U);
 
         /**
-         * @brief Set a new error message and raise error and warning flags
+         * @brief Set a new error type and raise error and warning flags
          *
          * @details Warn will set warning = true before calling set()
          * 
-         * @param   error_type_t TerminalCommanderTypes::error_type_t
+         * @param   error_type_t    TerminalCommanderTypes::error_type_t
+         * @param   error_context_t Meaning of the context value, or NoContext
+         * @param   uint16_t        Context value, e.g. a char position or I2C address
          * @returns void
          */
-        void warn(TerminalCommanderTypes::error_type_t error_type);
+        void warn(TerminalCommanderTypes::error_type_t error_type, 
+                  TerminalCommanderTypes::error_context_t context_type = TerminalCommanderTypes::NoContext, 
+                  uint16_t context = 0U);
 
         /**
          * @brief Clear error type and all flags
@@ -151,67 +487,354 @@
         void clear(void);
 
         /**
-         * @brief Clear error type, error message, and all flags
+         * @brief Clear error type, context, and all flags
          *
-         * @details Calls clear() then sets message array to '\0'
+         * @details Calls clear() then clears the context
          * 
          * @param   void
          * @returns void
          */
         void reset(void);
 
+        /**
+         * @brief Get the error message of the current error type
+         * 
+         * @param   void
+         * @returns __FlashStringHelper* Error message in PROGMEM, printable with Print::print()
+         */
+        const __FlashStringHelper *message(void) const;
+
+        /**
+         * @brief Print the error message followed by the context, if any
+         * 
+         * @param   Print&  Output to print the message to, e.g. Serial
+         * @returns size_t  Number of bytes printed
+         */
+        size_t printTo(Print &output) const;
+
         private:
           /** Array of char pointers for storing error messages in PROGMEM */
           static const char *const string_error_table[] PROGMEM;
       };
 
+    /**
+     * @class Output "terminal_commander.h"
+     * @brief Terminal output staging ring buffer
+     *
+     * @details Terminal responses are formatted into the staging buffer and
+     *          written to the Stream with a single write(buffer, length) call
+     *          according to the flush policy, instead of one print per fragment.
+     *          Unless the backpressure policy is TxBlock, flushing never writes
+     *          more than the Stream's availableForWrite(), and output which doesn't
+     *          fit the buffer is dropped and counted instead of waiting for the Stream.
+     *          The buffer is owned by the BasicTerminal which holds the Output.
+     */
+    class Output : public Print {
+      public:
+        /*! @brief Construct an instance of the Output class
+        *
+        * @param Stream*   Stream the staged output is written to
+        * @param uint8_t*  Staging buffer of buffer_size bytes
+        * @param size_t    Size of the staging buffer in bytes
+        */
+        Output(Stream *stream, uint8_t *buffer, const size_t buffer_size);
+
+        /**
+         * @brief Stage a single byte, flushing according to the flush policy
+         *
+         * @details Bytes dropped by the backpressure policy are counted by dropped(),
+         *          but reported as written so that Print continues with the rest.
+         * 
+         * @param   uint8_t Byte to write
+         * @returns size_t  Number of bytes written
+         */
+        size_t write(uint8_t data);
+
+        /**
+         * @brief Stage a block of bytes, flushing according to the flush policy
+         * 
+         * @param   uint8_t*  Bytes to write
+         * @param   size_t    Number of bytes to write
+         * @returns size_t    Number of bytes written
+         */
+        size_t write(const uint8_t *data, size_t size);
+
+        /**
+         * @brief Print a byte array as space separated, zero-padded upper-case hex
+         *
+         * @details Each nibble is converted with a lookup table and staged
+         *          directly, without Print's generic base conversion.
+         * 
+         * @param   uint8_t*      Bytes to print
+         * @param   size_t        Number of bytes to print
+         * @param   hex_format_t  HexPrefixed for "0x0A 0x1B" or HexSpaced for "0A 1B"
+         * @returns size_t        Number of chars printed
+         */
+        size_t printHex(const uint8_t *data, size_t size, 
+                        TerminalCommanderTypes::hex_format_t format = TerminalCommanderTypes::HexPrefixed);
+
+        /**
+         * @brief Write staged bytes to the Stream
+         *
+         * @details Writes all staged bytes with TxBlock, retrying the rest after
+         *          a short write for up to TERM_TX_BLOCK_TIMEOUT_MS without progress,
+         *          otherwise only as many as the Stream's availableForWrite() reports.
+         * 
+         * @param   void
+         * @returns void
+         */
+        void flush(void);
+
+        /**
+         * @brief Set what happens to output which doesn't fit the buffer
+         * 
+         * @param   backpressure_t  TxBlock, TxDrop or TxTruncate
+         * @returns void
+         */
+        void backpressure(TerminalCommanderTypes::backpressure_t backpressure_policy);
+
+        /**
+         * @brief Get the number of bytes dropped by the backpressure policy
+         * 
+         * @param   void
+         * @returns uint32_t  Bytes dropped since construction or resetDropped()
+         */
+        uint32_t dropped(void) const;
+
+        /**
+         * @brief Reset the number of dropped bytes
+         * 
+         * @param   void
+         * @returns void
+         */
+        void resetDropped(void);
+
+        /**
+         * @brief Set when the staged bytes are written to the Stream
+         * 
+         * @param   flush_policy_t  FlushPerLine, FlushPerResponse or FlushWhenFull
+         * @returns void
+         */
+        void policy(TerminalCommanderTypes::flush_policy_t flush_policy);
+
+        /**
+         * @brief Get when the staged bytes are written to the Stream
+         * 
+         * @param   void
+         * @returns flush_policy_t  Current flush policy
+         */
+        TerminalCommanderTypes::flush_policy_t policy(void) const;
+
+      private:
+        /** Stream the staged output is written to */
+        Stream *pStream;
+
+        /** Staging buffer, bufferSize bytes long */
+        uint8_t *const buffer;
+
+        /** Size of the staging buffer in bytes */
+        const size_t bufferSize;
+
+        /** Index of the oldest staged byte */
+        size_t head;
+
+        /** Number of bytes currently staged */
+        size_t length;
+
+        /** Number of bytes dropped by the backpressure policy */
+        uint32_t droppedBytes;
+
+        /** When the staged bytes are written to the Stream */
+        TerminalCommanderTypes::flush_policy_t flushPolicy;
+
+        /** What happens to output which doesn't fit the buffer */
+        TerminalCommanderTypes::backpressure_t backpressurePolicy;
+
+        /** True while the rest of a line is dropped by TxTruncate */
+        bool isTruncating;
+
+        /** True if the line ending of a truncated line was dropped and is still owed */
+        bool isLineEndingOwed;
+
+        /** True if the line ending of the line being truncated is dropped as well */
+        bool isLineEndingDropped;
+
+        /** True once a TxBlock write timed out, until the Stream accepts output again */
+        bool isStalled;
+
+        /*! @brief Append a byte to the staged bytes, which must not be full
+        * 
+        * @param   uint8_t Byte to append
+        * @returns void
+        */
+        void push(uint8_t data);
+
+        /*! @brief Write up to limit staged bytes to the Stream
+        * 
+        * @param   size_t  Maximum number of bytes to write
+        * @returns void
+        */
+        void drain(size_t limit);
+    };
+
+    /**
+     * @brief Parse a signed decimal argument, e.g. '-42'
+     *
+     * @details The argument parsers work on the token spans passed to argv callbacks
+     *          and need neither a null-terminated copy nor libc's scanf/strtol/atof.
+     *          On error the value is left unchanged and the error can be reported
+     *          with Terminal::error().
+     * 
+     * @param   token_t   Argument token
+     * @param   int32_t&  Parsed value
+     * @returns error_type_t  NoError, InvalidNumber, or NumberOutOfRange
+     */
+    TerminalCommanderTypes::error_type_t parseInt(const TerminalCommanderTypes::token_t &token, int32_t &value);
+
+    /**
+     * @brief Parse an unsigned decimal argument, e.g. '42'
+     * 
+     * @param   token_t   Argument token
+     * @param   uint32_t& Parsed value
+     * @returns error_type_t  NoError, InvalidNumber, or NumberOutOfRange
+     */
+    TerminalCommanderTypes::error_type_t parseUInt(const TerminalCommanderTypes::token_t &token, uint32_t &value);
+
+    /**
+     * @brief Parse a hexadecimal argument with or without '0x' prefix, e.g. '0x1F' or '1f'
+     * 
+     * @param   token_t   Argument token
+     * @param   uint32_t& Parsed value
+     * @returns error_type_t  NoError, InvalidNumber, or NumberOutOfRange
+     */
+    TerminalCommanderTypes::error_type_t parseHex(const TerminalCommanderTypes::token_t &token, uint32_t &value);
+
+    /**
+     * @brief Parse a decimal argument as a fixed-point value, e.g. '-1.25'
+     *
+     * @details The value is scaled by 10^fraction_digits, e.g. '-1.25' with 3 fraction
+     *          digits is -1250. Further fraction digits are rounded half away from zero.
+     * 
+     * @param   token_t   Argument token
+     * @param   uint8_t   Number of fraction digits of the result, at most 9
+     * @param   int32_t&  Parsed value scaled by 10^fraction_digits
+     * @returns error_type_t  NoError, InvalidNumber, or NumberOutOfRange
+     */
+    TerminalCommanderTypes::error_type_t parseFixed(const TerminalCommanderTypes::token_t &token, 
+                                                    const uint8_t fraction_digits, int32_t &value);
+
+    /**
+     * @brief Parse a decimal argument as a float, e.g. '-6.78' or '1.5e-3'
+     *
+     * @details Up to 9 significant digits are used, the rest are ignored.
+     * 
+     * @param   token_t   Argument token
+     * @param   float&    Parsed value
+     * @returns error_type_t  NoError, InvalidNumber, or NumberOutOfRange
+     */
+    TerminalCommanderTypes::error_type_t parseFloat(const TerminalCommanderTypes::token_t &token, float &value);
+
     /**
      * @class Command "terminal_commander.h"
      * @brief Terminal Commander command buffers, pointers, and indicies
+     *
+     * @details Incoming characters are lexed as they arrive: each character is
+     *          validated, used to locate the command and user argument spans in
+     *          serialRx, and decoded as a hex nibble into the twowire buffer, where
+     *          each pair of nibbles is packed into a byte, all in a single forward
+     *          pass. By the time the line ending is received the command is fully
+     *          parsed without having been copied.
+     *
+     *          Buffers are owned by the BasicTerminal which holds the Command,
+     *          index_t is the type used for all buffer indicies and lengths.
      */
+    template <typename index_t>
     class Command {
       public:
-        /** Fixed array for raw incoming serial rx data */
-        char serialRx[TERM_CHAR_BUFFER_SIZE + 1] = {'\0'};
+        /** Array for raw incoming serial rx data, bufferSize + 1 chars long */
+        char *const serialRx;
 
-        /** Fixed array for holding the received command data */
-        char data[TERM_CHAR_BUFFER_SIZE + 1] = {'\0'};
+        /** Array for holding bytes to be sent/received via TwoWire/I2C, starting with the address */
+        uint8_t *const twowire;
 
-        /** Fixed array for holding hex values to be sent/received via TwoWire/I2C */
-        uint8_t twowire[TERM_TWOWIRE_BUFFER_SIZE] = {0};
+        /** Maximum number of chars in an incoming line, excluding the line ending */
+        const index_t bufferSize;
 
-        /** Pointer to first non-space character following a space char in the incoming buffer */
+        /** Size of the twowire buffer in bytes */
+        const index_t twowireSize;
+
+        /** Pointer to first non-space character following the command delimiter in the incoming buffer */
         char *pArgs;
 
         /** Index of the serial buffer element pArgs points to */
-        uint8_t iArgs;
+        index_t iArgs;
+
+        /** Index of the first char of the command preceding the first command delimiter */
+        index_t cmdStart;
 
-        /** Total length in char of buffer preceding first command delimiter character*/
-        uint8_t cmdLength;
+        /** Length in char of the command at cmdStart, not including trailing whitespace */
+        index_t cmdLength;
 
-        /** Total length in char and without spaces of buffer after command delimiter character*/
-        uint8_t argsLength;
+        /** Length in char of the user args at pArgs, not including trailing whitespace */
+        index_t userArgsLength;
+
+        /** Number of non-whitespace chars received, not including the first command delimiter */
+        index_t charCount;
+
+        /** First four non-whitespace chars received (lower-case), used to identify built-in commands */
+        char prefix[4];
+
+        /** Number of hex nibbles decoded into the twowire buffer, twice its number of bytes */
+        index_t twowireLength;
+
+        /** Number of bytes to read given after '#' by an 'i2c r' command */
+        uint16_t readCount;
+
+        /** True if an 'i2c r' command gives its read count after '#' */
+        bool isReadCounted;
+
+        /** First error found in the incoming serial data, NoError if valid */
+        TerminalCommanderTypes::error_type_t inputError;
+
+        /** Index of the char which caused inputError */
+        index_t inputErrorIndex;
+
+        /** First error found when decoding the TwoWire hex data, NoError if valid */
+        TerminalCommanderTypes::error_type_t twowireError;
+
+        /** Index of the char which caused twowireError */
+        index_t twowireErrorIndex;
 
         /** Index of current character in incoming serial rx data array */
-        uint8_t index;
+        index_t index;
 
         /** True if incoming serial data transfer is complete (line ending was received) */
         bool complete;
 
-        /** True if incoming serial rx data overflowed the size allocated by TERM_CHAR_BUFFER_SIZE */
+        /** True if incoming serial rx data overflowed the size of the serialRx buffer,
+            all further input is then discarded until the line ending is received */
         bool overflow;
 
         /*! @brief Construct an instance of the Command class
         *
-        * @details Constructor for Command class, takes no arguments
+        * @details Constructor for Command class, buffers must outlive the Command
+        *
+        * @param char*    Serial rx buffer of buffer_size + 1 chars
+        * @param index_t  Maximum number of chars in an incoming line
+        * @param uint8_t* TwoWire buffer of twowire_size bytes
+        * @param index_t  Size of the TwoWire buffer in bytes
+        * @param char     The terminal command delimiter character
         */
-        Command(void);
+        Command(char *serial_rx, const index_t buffer_size, 
+                uint8_t *twowire, const index_t twowire_size, 
+                const char command_delimiter);
 
         /**
          * @brief Add character to buffer and increment buffer index
          *
-         * @details Add a single character to the incoming serialRx buffer
-         *          and increment the buffer index by 1
+         * @details Add a single character to the incoming serialRx buffer, lex it,
+         *          and increment the buffer index by 1. Once the buffer has
+         *          overflowed, characters are dropped until the line ending.
          * 
          * @param   char Character to add to the incoming buffer
          * @returns void
@@ -222,13 +845,41 @@
          * @brief Decrement buffer index and delete character at the previous index
          *
          * @details Decrement the index of the incoming serialRx buffer and 
-         *          reset the character at the previous index back to '\0'
+         *          reset the character at the previous index back to '\0'.
+         *          The remaining buffer contents are then lexed again.
          * 
          * @param   void
          * @returns void
          */
         void previous(void);
 
+        /**
+         * @brief Replace the command with its full name and lex the line again
+         *
+         * @details Used to expand an abbreviated command. The command chars are
+         *          replaced by the PROGMEM name, the remaining chars are shifted
+         *          to follow it and the whole line is lexed again.
+         * 
+         * @param   char*  Full command name in PROGMEM, not shorter than the command
+         * @returns bool   False if the expanded line does not fit the buffer
+         */
+        bool expand(const char *name_P);
+
+        /**
+         * @brief Split the user args into token spans
+         *
+         * @details Tokens are separated by the command delimiter, whitespace, ',' and ';'.
+         *          The tokens point into serialRx, nothing is copied.
+         * 
+         * @param   token_t*  Array receiving the tokens
+         * @param   uint8_t   Number of elements of the token array
+         * @param   uint8_t&  Number of tokens found
+         * @returns error_type_t  TooManyArguments or InvalidArgumentLength if the args
+         *                        don't fit the token array, otherwise NoError
+         */
+        TerminalCommanderTypes::error_type_t tokenize(TerminalCommanderTypes::token_t *tokens, 
+                                                      const uint8_t max_tokens, uint8_t &count) const;
+
         /**
          * @brief Clear incoming buffer contents and reset overflow and complete flags
          *
@@ -251,10 +902,10 @@
         void flushTwoWire(void);
 
         /**
-         * @brief Clear data and twowire buffers and reset all indicies, pointers, and flags
+         * @brief Clear twowire buffer and reset all indicies, pointers, and flags
          *
-         * @details Clear contents of the data and twowire buffers by setting all elements 
-         *          to '\0', and reset all indicies, pointers, and flags to default value.
+         * @details Clear contents of the twowire buffer by setting all elements to '\0',
+         *          and reset all indicies, pointers, and flags to default value.
          *          Note, this method does NOT clear data from the serialRx buffer.
          * 
          * @param   void
@@ -273,57 +924,177 @@
         void reset(void);
 
       private:
+        /** Command delimiter used to find the start of the user args */
+        const char delimiter;
+
+        /**
+         * @brief Reset the lexer state and clear the twowire buffer
+         * 
+         * @param   void
+         * @returns void
+         */
+        void resetLexer(void);
+
+        /**
+         * @brief Lex the serialRx character at the given index
+         *
+         * @details Single lexer step, called for each character in order of arrival
+         * 
+         * @param   index_t Index of the character in the serialRx buffer
+         * @returns void
+         */
+        void lex(index_t idx);
+
+        /**
+         * @brief Finish lexing once the line ending has been received
+         * 
+         * @param   void
+         * @returns void
+         */
+        void finalize(void);
     };
 
     /**
-     * @class Terminal "terminal_commander.h"
-     * @brief Terminal Commander terminal object
-     * 
-     * @details The Terminal class is an interactive serial terminal
-     *          for Arduino, providing serial buffer parsing
-     *          and command-line access to the I2C interface. The
-     *          class is intended to streamline the creation of a
-     *          simple command-line terminal on any Arduino device.
+     * @class TerminalBase "terminal_commander.h"
+     * @brief Terminal Commander terminal implementation
      * 
-     *          Construction requires a pointer to an instance of the
-     *          Stream class, and a pointer to an instance of the TwoWire
-     *          class. Optionally, a single-character command delimiter 
-     *          may be defined for deliniating custom user commands and 
-     *          their arguments. The default command delimiter is a space.
-     * 
-     * @param pSerial   A pointer to an instance of the Stream class
-     * @param pWire     A pointer to an instance of the TwoWire class
-     * @param char      A single ASCII character
+     * @details Implements the terminal on buffers owned by a BasicTerminal,
+     *          so that the code is shared by all terminals using the same
+     *          index type regardless of their buffer sizes. Use BasicTerminal
+     *          or Terminal to create a terminal, a reference to TerminalBase
+     *          can be used to handle terminals of different sizes alike.
      */
-    class Terminal {
+    template <typename index_t>
+    class TerminalBase {
       public:
-        /*! @brief Construct an instance of the Terminal class
-        *
-        * @details Constructor for the Terminal class.
-        *          Requires a pointer to an instance of the Stream class,
-        *          and a pointer to an instance of the TwoWire class.
-        *          Optionally, a single-character command delimiter may be 
-        *          defined for deliniating custom user commands and their
-        *          arguments. The default command delimiter is a space.
-        * 
-        * @param pSerial   A pointer to an instance of the Stream class
-        * @param pWire     A pointer to an instance of the TwoWire class
-        * @param char      A single ASCII character
-        */
-        Terminal(Stream *pSerial, TwoWire *pWire);
-        Terminal(Stream *pSerial, TwoWire *pWire, const char command_delimiter);
 
         /*! @brief The core Terminal method, place this in Arduino's loop()
          *
          * @details Handle all processing for the serial terminal, including reading
          *          and parsing of the serial buffer and execution of all callback
          *          functions. Place this method in the loop() section of Arduino code.
+         *          Never waits for input: at most one line is read and handled per
+         *          call, and an overlong line is discarded as it arrives.
          * 
          * @param   void
          * @returns void
         */
         void loop(void);
 
+        /*! @brief Time-budgeted variant of loop(), place this in Arduino's loop()
+         *
+         * @details Same as loop(), but stops reading input once budget_us has
+         *          elapsed and resumes on the next call. A line received within
+         *          a call whose budget is already spent is handled at the start
+         *          of the next call. A budget of zero means no limit. Note that
+         *          the handling of a line (including user callbacks) cannot be
+         *          split, use maxLoopMicros() to size the budget accordingly.
+         * 
+         * @param   uint32_t Time budget for this call in microseconds
+         * @returns void
+        */
+        void loop(uint32_t budget_us);
+
+        /*! @brief Get the worst-case loop() duration observed so far
+         * 
+         * @param   void
+         * @returns uint32_t Longest loop() call duration in microseconds
+        */
+        uint32_t maxLoopMicros(void) const;
+
+        /*! @brief Reset the worst-case loop() duration back to zero
+         * 
+         * @param   void
+         * @returns void
+        */
+        void resetMaxLoopMicros(void);
+
+        /*! @brief Check if a built-in command is still running
+         *
+         * @details 'scan' probes TERM_SCAN_PROBES_PER_LOOP addresses per loop()
+         *          call, so it completes over several calls. Input is not read
+         *          while it runs, except that any input cancels it. A line ending
+         *          which cancels it is consumed, other input is kept and read as
+         *          the next command.
+         * 
+         * @param   void
+         * @returns bool  True until the running command completes or is cancelled
+        */
+        bool busy(void) const;
+
+      #if TERM_TWOWIRE_PRESENCE_MS
+        /*! @brief Set how long an I2C device presence observed by 'scan' is trusted
+         *
+         * @details Scans record which addresses ACK, and reads and writes record
+         *          the addresses which ACK. Within the window, 'i2c' commands to
+         *          an address which did not ACK the scan fail right away without
+         *          a bus transaction, and 'scan --delta' only probes addresses
+         *          whose presence is unknown or older than the window. A read or
+         *          write NACK never marks an address absent, since busy devices
+         *          don't ACK either, e.g. an EEPROM during its write cycle. A window
+         *          of 0 disables the fast fail. Only available when
+         *          TERM_TWOWIRE_PRESENCE_MS is not 0.
+         * 
+         * @param   uint32_t  Window in milliseconds, TERM_TWOWIRE_PRESENCE_MS by default
+         * @returns void
+        */
+        void presenceWindow(uint32_t window_ms);
+      #endif
+
+        /*! @brief Set the Wire timeout, which the terminal restores after each 'scan' step
+         *
+         * @details 'scan' probes with a timeout of TERM_SCAN_TIMEOUT_US, and sets
+         *          the Wire timeout back once the probes of each loop() call are
+         *          done. Wire libraries can't report their timeout, so call this
+         *          instead of Wire.setWireTimeout() for a timeout other than the
+         *          Wire default (disabled). Only has an effect for Wire libraries
+         *          with setWireTimeout().
+         * 
+         * @param   uint32_t  Timeout in microseconds, 0 to disable the timeout
+         * @param   bool      True to reset the Wire hardware on a timeout
+         * @returns void
+        */
+        void twowireTimeout(uint32_t timeout_us, bool reset_with_timeout = false);
+
+        /*! @brief Read consecutive registers of an I2C device into a buffer
+         *
+         * @details Uses the same transactions as the 'i2c' commands, without any
+         *          terminal output: the range is read in chunks of up to
+         *          TERM_TWOWIRE_CHUNK_SIZE bytes, each starting with a write of its
+         *          first register, with the device settings of twowireDevice(),
+         *          retries and presence tracking. E.g. in a user callback:
+         *            uint8_t data[6];
+         *            if (Terminal.i2cRead(0x68, 0x3B, data, sizeof(data)) == NO_ERROR) {
+         *              // use data
+         *            }
+         *          An address known to be absent fails with NACK_ADDRESS without
+         *          a bus transaction, a device which returns fewer bytes than
+         *          requested fails with OTHER.
+         * 
+         * @param   uint8_t           7-bit I2C address of the device
+         * @param   uint8_t           First register to read
+         * @param   uint8_t*          Buffer of at least size bytes
+         * @param   size_t            Number of bytes to read
+         * @returns twi_error_type_t  NO_ERROR if all bytes were read
+        */
+        TerminalCommanderTypes::twi_error_type_t i2cRead(uint8_t i2c_address, uint8_t i2c_register, 
+                                                         uint8_t *data, size_t size);
+
+        /*! @brief Write a buffer to consecutive registers of an I2C device
+         *
+         * @details The counterpart of i2cRead(), the data is written in chunks
+         *          of up to TERM_TWOWIRE_CHUNK_SIZE - 1 bytes, each preceded by
+         *          its first register. A size of 0 only writes the register.
+         * 
+         * @param   uint8_t           7-bit I2C address of the device
+         * @param   uint8_t           First register to write
+         * @param   uint8_t*          Data to write
+         * @param   size_t            Number of bytes to write
+         * @returns twi_error_type_t  NO_ERROR if all bytes were written
+        */
+        TerminalCommanderTypes::twi_error_type_t i2cWrite(uint8_t i2c_address, uint8_t i2c_register, 
+                                                          const uint8_t *data, size_t size);
+
         /*! @brief Initialize the Terminal output, place this in Arduino's setup()
          *
          * @details This is an optional method to reduce visual clutter by initializing
@@ -350,6 +1121,145 @@
         */
         void echo(bool);
 
+        /*! @brief Enable unique-prefix abbreviation of commands
+         *
+         * @details When enabled, a command which doesn't match any command exactly
+         *          is resolved by its prefix, e.g. 'sc' runs 'scan' and 'i2 r 3101'
+         *          runs 'i2c r 3101'. The prefix must match a single user or built-in
+         *          command, otherwise an 'Ambiguous Command' error is reported.
+         *          Built-in commands are matched case insensitively, user commands
+         *          are case sensitive. Disabled by default.
+         * 
+         * @param   bool  Boolean to enable (true) or disable (false) abbreviations.
+         * @returns void
+        */
+        void abbreviate(bool);
+
+        /*! @brief Report an error from within a user callback
+         *
+         * @details The error message is printed once the callback returns, e.g.
+         *          for an argument which failed to parse:
+         *            if (parseInt(argv[0], value) != NoError) {
+         *              Terminal.error(InvalidNumber);
+         *            }
+         * 
+         * @param   error_type_t  Type of the error to report
+         * @returns void
+        */
+        void error(TerminalCommanderTypes::error_type_t error_type);
+
+        /*! @brief Set when terminal output is written to the serial Stream
+         *
+         * @details Terminal output is staged in a buffer and written in as few
+         *          write(buffer, length) calls as the policy allows:
+         *            FlushPerLine      after every line
+         *            FlushPerResponse  once per loop() call (default)
+         *            FlushWhenFull     only when the buffer is full, call flush()
+         *                              to write the remaining output
+         *          Staged output is always written before user callbacks run, so
+         *          that it is not reordered with their own output.
+         * 
+         * @param   flush_policy_t  FlushPerLine, FlushPerResponse or FlushWhenFull
+         * @returns void
+        */
+        void outputPolicy(TerminalCommanderTypes::flush_policy_t flush_policy);
+
+        /*! @brief Write staged terminal output to the serial Stream
+         *
+         * @details Writes all staged output with TxBlock, otherwise only as much
+         *          as the Stream's availableForWrite() reports.
+         * 
+         * @param   void
+         * @returns void
+        */
+        void flush(void);
+
+        /*! @brief Set what happens to terminal output when the Stream can't keep up
+         *
+         * @details With the default TxBlock, output waits for the Stream as usual.
+         *          Output is only dropped once a Stream accepted no bytes at all for
+         *          TERM_TX_BLOCK_TIMEOUT_MS, and without waiting again until it does.
+         *          With TxDrop or TxTruncate, loop() never writes more than the Stream's
+         *          availableForWrite() and output which doesn't fit the output buffer
+         *          is dropped, so a slow terminal never holds up the sketch:
+         *            TxDrop      drop bytes which don't fit
+         *            TxTruncate  drop the rest of a line once a byte doesn't fit,
+         *                        so that the following lines are intact
+         *          Requires a Stream which implements availableForWrite(), e.g.
+         *          HardwareSerial, otherwise all output is dropped.
+         * 
+         * @param   backpressure_t  TxBlock, TxDrop or TxTruncate
+         * @returns void
+        */
+        void backpressure(TerminalCommanderTypes::backpressure_t backpressure_policy);
+
+        /*! @brief Get the number of output bytes dropped by the backpressure policy
+         * 
+         * @param   void
+         * @returns uint32_t  Bytes dropped since construction or resetDroppedBytes()
+        */
+        uint32_t droppedBytes(void) const;
+
+        /*! @brief Reset the number of dropped output bytes
+         * 
+         * @param   void
+         * @returns void
+        */
+        void resetDroppedBytes(void);
+
+        /*! @brief Set the I2C read transaction settings of a device
+         *
+         * @details Register reads write the register and then read the data after
+         *          a repeated start, without a delay in between. Devices which need
+         *          time to prepare the data, or a STOP before the read, are
+         *          configured here, e.g. for a sensor at 0x40 which needs 20 us:
+         *            Terminal.twowireDevice(0x40, 20U);
+         *          At most TERM_TWOWIRE_DEVICE_SETTINGS devices can be configured.
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint16_t  Delay between the register write and the read in microseconds
+         * @param   bool      False to end the register write with a STOP instead of
+         *                    a repeated start
+         * @returns bool      False if the settings table is full
+        */
+        bool twowireDevice(uint8_t address, uint16_t delay_us, bool repeated_start = true);
+
+        /*! @brief Get the bus time of the last built-in I2C command
+         *
+         * @details Measured from the start of the first transaction to the end of
+         *          the last one, excluding terminal output, so the effect of the
+         *          bus clock and device settings can be verified.
+         * 
+         * @param   void
+         * @returns uint32_t  Duration of the last 'i2c' transactions in microseconds
+        */
+        uint32_t lastTransactionMicros(void) const;
+
+        /*! @brief Get the number of failed I2C transactions of an error type
+         *
+         * @details Every failed attempt is counted, including those which
+         *          succeeded on a retry. Address NACKs of 'scan' are not counted
+         *          since they are expected for absent devices.
+         * 
+         * @param   twi_error_type_t  Error returned by Wire.endTransmission()
+         * @returns uint32_t          Failures since construction or resetTwoWireErrors()
+        */
+        uint32_t twowireErrors(TerminalCommanderTypes::twi_error_type_t error) const;
+
+        /*! @brief Get the number of retried I2C transactions
+         * 
+         * @param   void
+         * @returns uint32_t  Retries since construction or resetTwoWireErrors()
+        */
+        uint32_t twowireRetries(void) const;
+
+        /*! @brief Reset the I2C error and retry counters
+         * 
+         * @param   void
+         * @returns void
+        */
+        void resetTwoWireErrors(void);
+
         /*! @brief Attach a lambda expression or function pointer to a terminal command
          *
          * @details Call this inside the Arduino 'setup' function. Usage is either with a lamba
@@ -360,6 +1270,9 @@
          *          or with a function pointer, where myfuction points to the address of a function
          *          which takes (char* args, size_t args_size) as arguments and returns void:
          *            Terminal.onCommand("mycommand", &myfuction);
+         *          Commands added once the terminal's command capacity is reached are ignored.
+         *          Commands are kept sorted by name for binary search, if a name is added
+         *          more than once the first callback added for it is used.
          * 
          * @param   char*                   Char array with the command name, e.g. 'mycommand'
          * @param   user_callback_char_fn_t Lambda expr. or fn pointer matching 'void (char*, size_t)'
@@ -367,16 +1280,287 @@
         */
         void onCommand(const char* command, TerminalCommanderTypes::user_callback_char_fn_t callback);
 
+        /*! @brief Attach an argv callback to a terminal command
+         *
+         * @details The callback receives the user args already split into tokens
+         *          by the command delimiter, whitespace, ',' and ';', e.g. for
+         *          'set 12, 345' it is called with the tokens "12" and "345":
+         *            Terminal.onCommand("set", [](const token_t* argv, uint8_t argc) {
+         *              // custom code here
+         *            }
+         *          Tokens point into the terminal buffer and are not null-terminated.
+         *          A command with more than TERM_MAX_ARGS tokens, or a token longer
+         *          than 255 chars, is reported as an error and the callback is not called.
+         * 
+         * @param   char*                   Char array with the command name, e.g. 'mycommand'
+         * @param   user_callback_argv_fn_t Lambda expr. or fn pointer matching 'void (const token_t*, uint8_t)'
+         * @returns void
+        */
+        void onCommand(const char* command, TerminalCommanderTypes::user_callback_argv_fn_t callback);
+
+        /*! @brief Attach an args callback with an argument schema to a terminal command
+         *
+         * @details The terminal validates and converts the user args according to the
+         *          schema before the callback is called, so malformed args never reach
+         *          user code. The schema lists one type per argument, separated by spaces:
+         *            i8 i16 i32  signed decimal, range checked
+         *            u8 u16 u32  unsigned decimal, range checked
+         *            hex         hexadecimal with or without '0x', 32 bit
+         *            fix0..fix9  fixed-point decimal scaled by 10^N, see parseFixed()
+         *            float       decimal float, see parseFloat()
+         *            str         unconverted token
+         *          A type followed by '?' is optional, a last type followed by '*' may be
+         *          repeated any number of times, e.g. "u8 u16 hex*". For example:
+         *            Terminal.onCommand("pwm", "u8 u16", [](const arg_value_t* args, uint8_t count) {
+         *              analogWrite(args[0].u, args[1].u);
+         *            }
+         *          The callback receives one value per argument, at most TERM_MAX_ARGS.
+         *          The schema is validated when the command is added, a schema with an
+         *          unknown type, more than TERM_MAX_ARGS types, a required type after
+         *          an optional one or a repeated type which is not the last is rejected.
+         *          Like the command name, the schema is kept by pointer and must stay
+         *          valid, it is compiled each time the command is run.
+         * 
+         * @param   char*                   Char array with the command name, e.g. 'mycommand'
+         * @param   char*                   Argument schema, e.g. 'u8 u16 hex*'
+         * @param   user_callback_args_fn_t Lambda expr. or fn pointer matching 'void (const arg_value_t*, uint8_t)'
+         * @returns bool  False, and the command is not added, if the schema is invalid
+        */
+        bool onCommand(const char* command, const char* schema, 
+                       TerminalCommanderTypes::user_callback_args_fn_t callback);
+
+        /*! @brief Attach a sorted table of commands stored in PROGMEM
+         *
+         * @details The table is used in place, no SRAM is used for its names or
+         *          callbacks and no registration work is done at startup. Declare it
+         *          constexpr and PROGMEM, sorted by name, e.g.:
+         *            static constexpr user_callback_P_t my_commands[] PROGMEM = {
+         *              { "led", &led_callback },
+         *              { "set", &set_callback },
+         *            };
+         *            static_assert(isCommandTableSorted(my_commands), "unsorted commands");
+         *            Terminal.onCommands(my_commands);
+         *          Commands added with onCommand() are checked first and may overload
+         *          a command of the table. Attaching another table replaces the previous.
+         *          The order of the names and all schemas of the table are validated
+         *          when it is attached, the schema of a table command is compiled
+         *          when the command is run.
+         * 
+         * @param   user_callback_P_t[] Sorted command table in PROGMEM
+         * @returns bool  False, and the table is not attached, if the table is not
+         *                sorted, repeats a name or holds an invalid schema
+        */
+        template <size_t N>
+        bool onCommands(const TerminalCommanderTypes::user_callback_P_t (&table)[N]) {
+          static_assert((N > 0U) && (N <= (size_t)((index_t)~0U)), "Command table size is not supported by this terminal");
+          return this->onCommands(table, (index_t)N);
+        }
+
+        /*! @brief Attach a sorted table of commands stored in PROGMEM
+         * 
+         * @param   user_callback_P_t*  Sorted command table in PROGMEM
+         * @param   index_t             Number of commands in the table
+         * @returns bool  False, and the table is not attached, if the table is not
+         *                sorted, repeats a name or holds an invalid schema
+        */
+        bool onCommands(const TerminalCommanderTypes::user_callback_P_t *table, const index_t count);
+
+      #if TERM_REGISTER_CACHE_SIZE
+        /*! @brief Declare registers of an I2C device as cacheable
+         *
+         * @details i2cRead() and 'i2c r' serve cacheable registers which hold a
+         *          value from the shadow cache, and read only the others from the
+         *          device, filling in the cache. i2cWrite() to cacheable registers
+         *          only updates the shadow and marks them dirty until they are
+         *          written by flushRegisters(), 'i2c w' always writes the device.
+         *          'i2c dump' always reads the device. Declare configuration
+         *          registers only, e.g.:
+         *            Terminal.cacheRegisters(0x68, 0x19, 4);   // config registers
+         *            Terminal.uncacheRegisters(0x68, 0x1A);    // except a volatile one
+         *          Only available when TERM_REGISTER_CACHE_SIZE is not 0.
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   First cacheable register
+         * @param   uint16_t  Number of cacheable registers
+         * @returns bool      False, and nothing declared, if the cache can't hold them
+        */
+        bool cacheRegisters(uint8_t i2c_address, uint8_t first, uint16_t count = 1U);
+
+        /*! @brief Declare registers of an I2C device as uncached, e.g. volatile registers
+         *
+         * @details Removes the registers from the shadow cache, including values
+         *          which were not flushed yet.
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   First uncached register
+         * @param   uint16_t  Number of uncached registers
+         * @returns void
+        */
+        void uncacheRegisters(uint8_t i2c_address, uint8_t first, uint16_t count = 1U);
+
+        /*! @brief Discard the shadow values of cached registers
+         *
+         * @details The next read of the registers reads the device, values which
+         *          were not flushed yet are lost.
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   First register, all registers of the device by default
+         * @param   uint16_t  Number of registers
+         * @returns void
+        */
+        void invalidateRegisters(uint8_t i2c_address, uint8_t first = 0U, uint16_t count = 0x100U);
+
+        /*! @brief Write all dirty registers of the shadow cache to their devices
+         *
+         * @details Consecutive dirty registers of a device are written in a single
+         *          burst of up to TERM_TWOWIRE_CHUNK_SIZE - 1 registers. Registers
+         *          which could not be written stay dirty.
+         * 
+         * @param   void
+         * @returns twi_error_type_t  NO_ERROR or the error of the first failed burst
+        */
+        TerminalCommanderTypes::twi_error_type_t flushRegisters(void);
+
+        /*! @brief Get the number of register values served from the shadow cache
+         * 
+         * @param   void
+         * @returns uint32_t  Hits since construction or resetRegisterCacheCounters()
+        */
+        uint32_t registerCacheHits(void) const;
+
+        /*! @brief Get the number of cacheable register values read from the device
+         * 
+         * @param   void
+         * @returns uint32_t  Misses since construction or resetRegisterCacheCounters()
+        */
+        uint32_t registerCacheMisses(void) const;
+
+        /*! @brief Reset the shadow cache hit and miss counters
+         * 
+         * @param   void
+         * @returns void
+        */
+        void resetRegisterCacheCounters(void);
+      #endif
+
+      #if TERM_PROFILING
+        /*! @brief Get the throughput counters and per-stage timing statistics
+         *
+         * @details Counters accumulate from construction or the last call to
+         *          resetProfile(). Only available when TERM_PROFILING is 1.
+         * 
+         * @param   void
+         * @returns profile_t  Reference to the terminal's profiling counters
+        */
+        const TerminalCommanderTypes::profile_t& profile(void) const;
+
+        /*! @brief Reset all throughput counters and per-stage timing statistics
+         * 
+         * @param   void
+         * @returns void
+        */
+        void resetProfile(void);
+      #endif
+
+      protected:
+        /*! @brief Construct an instance of the TerminalBase class
+        *
+        * @details Called by BasicTerminal with the buffers it owns
+        * 
+        * @param pSerial   A pointer to an instance of the Stream class
+        * @param pWire     A pointer to an instance of the TwoWire class
+        * @param char      A single ASCII character
+        * @param char*     Serial rx buffer of buffer_size + 1 chars
+        * @param index_t   Maximum number of chars in an incoming line
+        * @param uint8_t*  TwoWire buffer of twowire_size bytes
+        * @param index_t   Size of the TwoWire buffer in bytes
+        * @param user_callback_char_t*  User command array of max_user_commands elements
+        * @param index_t   Maximum number of user commands
+        * @param uint8_t*  Output staging buffer of output_size bytes
+        * @param size_t    Size of the output staging buffer in bytes
+        */
+        TerminalBase(Stream *pSerial, TwoWire *pWire, const char command_delimiter, 
+                     char *serial_rx, const index_t buffer_size, 
+                     uint8_t *twowire, const index_t twowire_size, 
+                     TerminalCommanderTypes::user_callback_char_t *user_callbacks, 
+                     const index_t max_user_commands, 
+                     uint8_t *output_buffer, const size_t output_size);
+
       private:
         /** A struct array for storing user commands and their corresponding fn pointers */
-        TerminalCommanderTypes::user_callback_char_t userCharCallbacks[MAX_USER_COMMANDS] = {};
+        TerminalCommanderTypes::user_callback_char_t *const userCharCallbacks;
+
+        /** Maximum number of user callbacks that can be added by onCommand() */
+        const index_t maxUserCharCallbacks;
 
         /** Increments by one for each user callback added by onCommand() */
-        uint8_t numUserCharCallbacks = 0;
+        index_t numUserCharCallbacks = 0;
+
+        /** Sorted user command table in PROGMEM attached by onCommands(), if any */
+        const TerminalCommanderTypes::user_callback_P_t *userTableCallbacks = nullptr;
+
+        /** Number of commands in userTableCallbacks */
+        index_t numUserTableCallbacks = 0;
 
         /** True if serial terminal echo is enabled */
         bool isEchoEnabled = false;
 
+        /** True if commands may be abbreviated to a unique prefix */
+        bool isAbbreviationEnabled = false;
+
+        /** Longest loop() call duration observed in microseconds */
+        uint32_t maxLoopDuration = 0UL;
+
+        /** Transaction settings of individual I2C devices, added by twowireDevice() */
+        TerminalCommanderTypes::twowire_device_t twowireDevices[TERM_TWOWIRE_DEVICE_SETTINGS] = {};
+
+        /** Number of I2C devices with settings in twowireDevices */
+        uint8_t numTwoWireDevices = 0U;
+
+        /** Bus time of the last built-in I2C command in microseconds */
+        uint32_t lastTransactionDuration = 0UL;
+
+        /** Failed I2C transactions per twi_error_type_t, excluding NO_ERROR */
+        uint32_t twowireErrorCounts[TerminalCommanderTypes::TIME_OUT] = {};
+
+        /** Retried I2C transactions */
+        uint32_t twowireRetryCount = 0UL;
+
+        /** Retries left to the current built-in I2C command for twowireRetryAddress */
+        uint8_t twowireRetryBudget = 0U;
+
+        /** Address the retry budget applies to, 0x80 (no 7-bit address) for a new command */
+        uint8_t twowireRetryAddress = 0x80U;
+
+        /** Wire timeout restored after the probes of 'scan', see twowireTimeout() */
+        uint32_t twowireTimeoutMicros = 0UL;
+
+        /** Wire reset_with_timeout flag restored after the probes of 'scan' */
+        bool isTwoWireTimeoutReset = false;
+
+        /** Next address to be probed by a running 'scan', 0 if no scan is running */
+        uint8_t scanAddress = 0U;
+
+        /** Number of devices found by the running 'scan', or changed for 'scan --delta' */
+        uint8_t scanDeviceCount = 0U;
+
+        /** True if the running scan only probes unknown and stale addresses */
+        bool isScanDelta = false;
+
+      #if TERM_TWOWIRE_PRESENCE_MS
+        /** Bitmap of I2C addresses which ACKed when last observed */
+        uint8_t twowirePresent[16] = {0};
+
+        /** Bitmap of I2C addresses probed by 'scan' since their row was last scanned */
+        uint8_t twowireKnown[16] = {0};
+
+        /** millis() at which 'scan' started probing each row of 8 addresses */
+        uint32_t twowireRowMillis[16] = {0};
+
+        /** Time in milliseconds for which a recorded presence is trusted */
+        uint32_t twowirePresenceWindow = TERM_TWOWIRE_PRESENCE_MS;
+      #endif
+
         /** True if the terminal object is ready for the next command and should print '>>' prompt */
         bool isNewTerminalCommandPrompt = true;
 
@@ -387,14 +1571,36 @@
         Error lastError;
 
         /** Instance of the Command class for maintaining incoming buffers, indicies, and pointers */
-        Command command;
+        Command<index_t> command;
 
         /** Pointer to an instance of the Arduino Stream class, specified when calling constructor */
         Stream *pSerial;
 
+        /** Staging buffer for all terminal output written to pSerial */
+        Output output;
+
         /** Pointer to an instance of the Arduino Wire class, specified when calling constructor */
         TwoWire *pWire;
 
+      #if TERM_REGISTER_CACHE_SIZE
+        /** Shadow cache of I2C registers, sorted by address and register */
+        TerminalCommanderTypes::twowire_register_t registerCache[TERM_REGISTER_CACHE_SIZE] = {};
+
+        /** Number of registers in registerCache */
+        uint8_t numCachedRegisters = 0U;
+
+        /** Register values served from registerCache */
+        uint32_t registerCacheHitCount = 0UL;
+
+        /** Cacheable register values which were read from the device */
+        uint32_t registerCacheMissCount = 0UL;
+      #endif
+
+      #if TERM_PROFILING
+        /** Throughput counters and per-stage timing statistics */
+        TerminalCommanderTypes::profile_t stats = {};
+      #endif
+
         /*! @brief  Process the incoming raw serialRx data buffer
          *
          * @details  Called once when a newline character is received from the terminal.
@@ -410,51 +1616,269 @@
          *
          * @details Check that the incoming serialRx buffer is not empty and contains only
          *          allowed ASCII characters (letters, numbers, some symbols, and delimiter).
+         *          The characters themselves are checked by the lexer as they arrive.
          * 
-         * @param   param Description of the input parameter
+         * @param   void
          * @returns bool  True if buffer is not empty and all characters are allowed
          */
         bool isRxBufferDataValid(void);
 
-        /*! @brief Remove all whitespace characters from the incoming serial command
+        /*! @brief Check for user callbacks and call one if the command matches
          *
-         * @details Removes all whitespace from the incoming serial command, copies this
-         *          over to a separate data buffer (original buffer is not modified), and
-         *          records the index of and a pointer to the first command delimiter found.
+         * @details Binary search the incoming command (as denoted by the command delimiter)
+         *          in the sorted array of user commands, then in the PROGMEM command
+         *          table, if any. This happens prior to the built-in 'i2c' or 'scan'
+         *          commands being checked for, allowing these commands to be
+         *          overloaded if desired. If a command matches,
+         *          execute the user callback and pass any remaining arguments to it.
          * 
          * @param   void
-         * @returns bool  True if no errors occured during whitespace removal
+         * @returns bool  True if a user command matched, lastError is set if it failed
+         */
+        bool runUserCallbacks(void);
+
+        /*! @brief Add a user command, keeping the array of user commands sorted
+         * 
+         * @param   user_callback_char_t  User command and its callback
+         * @returns void
          */
-        bool removeSpaces(void);
+        void addUserCallback(const TerminalCommanderTypes::user_callback_char_t &user_callback);
 
-        /*! @brief Check for user callbacks and call one if the command matches
+        /*! @brief Find the user callback of a command
          *
-         * @details Check the incoming command (as denoted by the command delimiter)
-         *          against the array of user commands, if any. This happens prior to
-         *          the built-in 'i2c' or 'scan' commands being checked for, allowing
-         *          these commands to be overloaded if desired. If a command matches,
-         *          execute the user callback and pass any remaining arguments to it.
+         * @details Binary search the sorted array of user commands, then the
+         *          PROGMEM command table, for the command span.
+         * 
+         * @param   char*     Command span, not null-terminated
+         * @param   index_t   Number of chars in the command span
+         * @param   user_callback_char_t&  Callbacks of the command, if found
+         * @returns bool  True if the command was found
+         */
+        bool findUserCallback(const char *span, const index_t length, 
+                              TerminalCommanderTypes::user_callback_char_t &user_callback);
+
+        /*! @brief Call a user callback with the user args of the current command
+         *
+         * @details Argv callbacks are passed the args split into tokens, args callbacks
+         *          are only called once all args have been converted by their schema.
+         * 
+         * @param   user_callback_char_t  Callbacks of the command
+         * @returns bool  True if the callback was called
+         */
+        bool callUserCallback(const TerminalCommanderTypes::user_callback_char_t &user_callback);
+
+        /*! @brief Run the single user or built-in command starting with the command
+         *
+         * @details Called once no command matched exactly and abbreviations are enabled.
+         *          The sorted tables keep all names sharing a prefix next to each other,
+         *          so candidates are found with one binary search per table. A built-in
+         *          command is expanded to its full name in the serialRx buffer and the
+         *          line is processed again.
          * 
          * @param   void
-         * @returns bool  True if no errors occured during callback checks and execution
+         * @returns bool  True if a unique command was found and run without errors
          */
-        bool runUserCallbacks(void);
+        bool runAbbreviatedCommand(void);
+
+        /*! @brief Check if the lexed command prefix identifies a built-in command
+         * 
+         * @param   void
+         * @returns bool  True for the 'i2c' and 'scan' commands
+         */
+        bool isBuiltInCommand(void) const;
+
+        /*! @brief Run the built-in command identified by the lexed command prefix
+         * 
+         * @param   void
+         * @returns bool  True if the built-in command ran without errors
+         */
+        bool runBuiltInCommand(void);
 
         /*! @brief Parse and error-check the incoming TwoWire command string
          *
          * @details Checks TwoWire data to ensure it only contains hex value pairs,
-         *          no additional characters or half-bytes of data.
+         *          no additional characters or half-bytes of data. The hex values
+         *          themselves are decoded by the lexer as they arrive.
          * 
          * @param   void
          * @returns bool  True if TwoWire buffer is not empty and has valid contents
          */
         bool parseTwoWireData(void);
 
+        /*! @brief  Write a register address and optional data to the TwoWire bus
+         *
+         * @details A transaction which fails with a bus error or timeout, or with
+         *          an address NACK if TERM_TWOWIRE_RETRY_ADDRESS_NACK is set, is
+         *          retried up to TERM_TWOWIRE_RETRIES times with an exponential
+         *          backoff, as long as the retry budget of the command for this
+         *          address lasts. Each failed attempt is counted by its error type.
+         * 
+         * @param   uint8_t           7-bit I2C address of the device
+         * @param   uint8_t           Register to write to
+         * @param   uint8_t*          Data to write after the register, may be nullptr
+         * @param   index_t           Number of data bytes
+         * @param   bool              True to end the transaction with a STOP
+         * @returns twi_error_type_t  NO_ERROR or the error of the last attempt
+         */
+        TerminalCommanderTypes::twi_error_type_t transmitTwoWire(uint8_t i2c_address, uint8_t i2c_register, 
+                                                                 const uint8_t *data, index_t size, bool stop);
+
+        /*! @brief  Report a failed TwoWire transaction as the terminal error
+         * 
+         * @param   twi_error_type_t  Error returned by transmitTwoWire()
+         * @param   uint8_t           7-bit I2C address of the device
+         * @returns bool              Always false
+         */
+        bool setTwoWireError(TerminalCommanderTypes::twi_error_type_t error, uint8_t i2c_address);
+
+        /*! @brief  Check if an address is known to be absent
+         * 
+         * @param   uint8_t   7-bit I2C address
+         * @returns bool      True if the address did not ACK the last scan within the
+         *                    presence window, always false without the presence cache
+         */
+        bool isTwoWireAbsent(uint8_t i2c_address) const;
+
+        /*! @brief  Record the presence of an address from a read or write result
+         *
+         * @details An ACKed address, even with a data NACK, is present. Other
+         *          results are not recorded, since a busy device NACKs its
+         *          address too. Does nothing without the presence cache.
+         * 
+         * @param   uint8_t           7-bit I2C address
+         * @param   twi_error_type_t  Result of the transaction to the address
+         * @returns void
+         */
+        void setTwoWirePresence(uint8_t i2c_address, TerminalCommanderTypes::twi_error_type_t error);
+
+      #if TERM_TWOWIRE_PRESENCE_MS
+        /*! @brief  Check if the presence of an address was recorded within the window
+         * 
+         * @param   uint8_t   7-bit I2C address
+         * @returns bool      True if the address' row has not expired and the address was probed
+         */
+        bool isTwoWireKnown(uint8_t i2c_address) const;
+
+        /*! @brief  Record the presence of an address from a 'scan' probe
+         *
+         * @details An ACKed address is present and an address NACK is absent,
+         *          other errors make the presence unknown. Recording into an
+         *          expired row forgets the rest of the row and restarts its window.
+         * 
+         * @param   uint8_t           7-bit I2C address
+         * @param   twi_error_type_t  Result of the probe of the address
+         * @returns void
+         */
+        void recordTwoWireProbe(uint8_t i2c_address, TerminalCommanderTypes::twi_error_type_t error);
+      #endif
+
+        /*! @brief  Write a register address and request bytes from it
+         *
+         * @details The register is written with a repeated start, unless the
+         *          device is configured otherwise with twowireDevice(), and the
+         *          bus time is added to lastTransactionDuration. Nothing is
+         *          requested if the register write failed.
+         * 
+         * @param   uint8_t           7-bit I2C address of the device
+         * @param   uint8_t           Register to read from
+         * @param   uint8_t           Number of bytes to request
+         * @returns twi_error_type_t  Error returned by the register write
+         */
+        TerminalCommanderTypes::twi_error_type_t requestTwoWire(uint8_t i2c_address, uint8_t i2c_register, 
+                                                                uint8_t quantity);
+
+        /*! @brief  Read consecutive registers in chunks of up to TERM_TWOWIRE_CHUNK_SIZE bytes
+         * 
+         * @param   uint8_t           7-bit I2C address of the device
+         * @param   uint8_t           First register to read
+         * @param   uint8_t*          Buffer of at least size bytes
+         * @param   size_t            Number of bytes to read
+         * @param   twi_error_type_t  Set to the error of the failed register write, if any
+         * @returns size_t            Number of bytes read, less than size if the device
+         *                            returned fewer bytes or a register write failed
+         */
+        size_t readTwoWireBytes(uint8_t i2c_address, uint8_t i2c_register, uint8_t *data, size_t size, 
+                                TerminalCommanderTypes::twi_error_type_t &error);
+
+        /*! @brief  Read consecutive registers through the register shadow cache
+         *
+         * @details Same as readTwoWireBytes(), but registers which are cached and
+         *          valid, including dirty ones with their pending values, are served
+         *          from the shadow cache. Each run of the other registers is read
+         *          from the device in one transaction, filling in its cached ones.
+         * 
+         * @param   uint8_t           7-bit I2C address of the device
+         * @param   uint8_t           First register to read
+         * @param   uint8_t*          Buffer of at least size bytes
+         * @param   size_t            Number of bytes to read
+         * @param   twi_error_type_t  Set to the error of the failed register write, if any
+         * @returns size_t            Number of bytes read
+         */
+        size_t readRegisters(uint8_t i2c_address, uint8_t i2c_register, uint8_t *data, size_t size, 
+                             TerminalCommanderTypes::twi_error_type_t &error);
+
+      #if TERM_REGISTER_CACHE_SIZE
+        /*! @brief  Find a register in the shadow cache
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   Register
+         * @returns uint8_t   Index of the register, or of the first entry after it
+         *                    if it is not cached
+         */
+        uint8_t findRegister(uint8_t i2c_address, uint8_t i2c_register) const;
+
+        /*! @brief  Count the registers of a range which are in the shadow cache
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   First register
+         * @param   size_t    Number of registers
+         * @param   uint8_t   Flags all counted registers must have, 0 to count all
+         * @returns size_t    Number of registers in the cache with the flags
+         */
+        size_t countRegisters(uint8_t i2c_address, uint8_t first, size_t count, uint8_t flags) const;
+
+        /*! @brief  Update the cached registers of a range with new values
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   First register
+         * @param   uint8_t*  Values of the registers
+         * @param   size_t    Number of registers
+         * @param   uint8_t   Flags of the updated registers, RegisterValid and
+         *                    optionally RegisterDirty
+         * @returns void
+         */
+        void storeRegisters(uint8_t i2c_address, uint8_t first, const uint8_t *data, size_t count, uint8_t flags);
+
+        /*! @brief  Mark the cached registers of a range unknown after a failed write
+         *
+         * @details Dirty registers keep their pending values, which the failed
+         *          write may not have overwritten on the device.
+         * 
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   First register
+         * @param   size_t    Number of registers
+         * @returns void
+         */
+        void discardRegisters(uint8_t i2c_address, uint8_t first, size_t count);
+
+        /*! @brief  Check if an entry of the shadow cache holds a register
+         * 
+         * @param   uint8_t   Index of the entry, may be past the last entry
+         * @param   uint8_t   7-bit I2C address of the device
+         * @param   uint8_t   Register
+         * @returns bool      True if entry k holds the register
+         */
+        bool isRegisterEntry(uint8_t k, uint8_t i2c_address, uint8_t i2c_register) const;
+      #endif
+
         /*! @brief  Read bytes from an address on the TwoWire bus
          *
          * @details Read the requested registers from the TwoWire bus (as specified
          *          by the incoming command data). Can perform sequential reads, if
-         *          supported by the IC being read from.
+         *          supported by the IC being read from. The number of registers is
+         *          given either by dummy bytes, e.g. 'i2c r 31 02 00 00', or in
+         *          decimal after '#', e.g. 'i2c r 31 02 #64', which is read in
+         *          chunks of the twowire buffer and not limited by its size.
          * 
          * @param   void
          * @returns bool  True if the read operation was successful and without errors
@@ -472,17 +1896,61 @@
          */
         bool writeTwoWire(void);
 
-        /*! @brief  Scan and report all devices on the TwoWire bus
+        /*! @brief  Print a hexdump of a register range of an address on the TwoWire bus
          *
-         * @details Scans the TwoWire bus and prints the address of all devices that
-         *          ACK a transmission start operation. Scans all 7-bit addresses
-         *          from 0 to 127.
+         * @details The 'i2c dump' command takes an address, a start register and
+         *          a byte count of up to 0x100, all in hex, e.g. 'i2c dump 50 00 100'.
+         *          The range is read in transactions of up to TERM_TWOWIRE_CHUNK_SIZE
+         *          bytes and each line is printed as soon as its bytes arrive, so
+         *          the range is never held in RAM.
          * 
          * @param   void
-         * @returns bool  True if the scan operation was successful and without errors
+         * @returns bool  True if the whole range was read without errors
+         */
+        bool dumpTwoWire(void);
+
+        /*! @brief  Print a single line of a TwoWire hexdump
+         *
+         * @details Prints the register of the first byte, up to 16 bytes in hex and
+         *          the printable ASCII chars of the bytes, e.g.
+         *          "10: 48 65 6C 6C 6F 00 ...  |Hello.|"
+         * 
+         * @param   uint8_t   Register of the first byte of the line
+         * @param   uint8_t*  Bytes of the line
+         * @param   uint8_t   Number of bytes of the line
+         * @returns void
+         */
+        void printHexdumpLine(uint8_t i2c_register, const uint8_t *data, uint8_t size);
+
+        /*! @brief  Start a scan of all devices on the TwoWire bus
+         *
+         * @details Only checks the arguments, the scan itself is run by
+         *          runTwoWireScan() from the following loop() calls. 'scan --delta'
+         *          only probes addresses whose presence is unknown or expired,
+         *          see presenceWindow(), and is rejected without the presence cache.
+         * 
+         * @param   void
+         * @returns bool  True if the scan was started
          */
         bool scanTwoWireBus(void);
 
+        /*! @brief  Continue a running scan of the TwoWire bus
+         *
+         * @details Probes the next TERM_SCAN_PROBES_PER_LOOP 7-bit addresses and
+         *          prints the address of each device that ACKs the transmission
+         *          start as soon as it is found, up to address 127. A delta scan
+         *          prints the devices which appeared or disappeared instead. Where
+         *          the Wire library supports it, the probes run with a Wire timeout
+         *          of TERM_SCAN_TIMEOUT_US so that a stuck bus can't stall the scan,
+         *          and the timeout set with twowireTimeout() is restored after them.
+         *          Any pending input cancels the scan, a line ending is consumed and
+         *          other input is left to be read as the next command.
+         * 
+         * @param   void
+         * @returns void
+         */
+        void runTwoWireScan(void);
+
         /*! @brief  Print the hexadecimal TwoWire address value to the console
          *
          * @details Automatically prepends an additional zero if the address
@@ -505,5 +1973,86 @@
          */
         void printTwoWireRegister(uint8_t i2c_register);
     };
+
+    /**
+     * @class BasicTerminal "terminal_commander.h"
+     * @brief Terminal Commander terminal object with compile-time sizes
+     * 
+     * @details The BasicTerminal class is an interactive serial terminal
+     *          for Arduino, providing serial buffer parsing
+     *          and command-line access to the I2C interface. The
+     *          class is intended to streamline the creation of a
+     *          simple command-line terminal on any Arduino device.
+     * 
+     *          Buffer sizes and user command capacity are template parameters,
+     *          so that terminals of different sizes can share a program and
+     *          each only pays for its own buffers. Terminals of up to 255 chars
+     *          and commands index with uint8_t, larger terminals with uint16_t.
+     * 
+     *          Construction requires a pointer to an instance of the
+     *          Stream class, and a pointer to an instance of the TwoWire
+     *          class. Optionally, a single-character command delimiter 
+     *          may be defined for deliniating custom user commands and 
+     *          their arguments. The default command delimiter is a space.
+     * 
+     * @tparam RxSize       Terminal input buffer length in chars
+     * @tparam MaxCommands  Maximum number of unique user-defined commands
+     * @tparam TwiSize      TwoWire read/write buffer length in bytes
+     * @tparam OutSize      Output staging buffer length in bytes
+     * @param  pSerial      A pointer to an instance of the Stream class
+     * @param  pWire        A pointer to an instance of the TwoWire class
+     * @param  char         A single ASCII character
+     */
+    template <size_t RxSize, size_t MaxCommands, size_t TwiSize, size_t OutSize = TERM_OUTPUT_BUFFER_SIZE>
+    class BasicTerminal : public TerminalBase<typename TerminalCommanderTypes::index_type<
+                                                ((RxSize > 255U) || (MaxCommands > 255U))>::type> {
+      static_assert((RxSize > 0U) && (RxSize < 65535U), "Terminal buffer size must be 1 to 65534 chars");
+      static_assert((MaxCommands > 0U) && (MaxCommands < 65536U), "Terminal supports 1 to 65535 user commands");
+      static_assert((TwiSize > 0U) && (TwiSize <= RxSize), "TwoWire buffer size must not exceed terminal character buffer size");
+      static_assert(OutSize > 0U, "Output buffer size must be at least 1 byte");
+
+      public:
+        /** Type used for all buffer indicies and lengths of this terminal */
+        typedef typename TerminalCommanderTypes::index_type<
+          ((RxSize > 255U) || (MaxCommands > 255U))>::type index_t;
+
+        /*! @brief Construct an instance of the BasicTerminal class
+        *
+        * @details Constructor for the BasicTerminal class.
+        *          Requires a pointer to an instance of the Stream class,
+        *          and a pointer to an instance of the TwoWire class.
+        *          Optionally, a single-character command delimiter may be 
+        *          defined for deliniating custom user commands and their
+        *          arguments. The default command delimiter is a space.
+        * 
+        * @param pSerial   A pointer to an instance of the Stream class
+        * @param pWire     A pointer to an instance of the TwoWire class
+        * @param char      A single ASCII character
+        */
+        BasicTerminal(Stream *pSerial, TwoWire *pWire, 
+                      const char command_delimiter = TERM_DEFAULT_CMD_DELIMITER) :
+          TerminalBase<index_t>(pSerial, pWire, command_delimiter, 
+                                serialRx, (index_t)RxSize, 
+                                twowire, (index_t)TwiSize, 
+                                userCharCallbacks, (index_t)MaxCommands, 
+                                outputBuffer, OutSize) {}
+
+      private:
+        /** Fixed array for raw incoming serial rx data */
+        char serialRx[RxSize + 1] = {'\0'};
+
+        /** Fixed array for holding hex values to be sent/received via TwoWire/I2C */
+        uint8_t twowire[TwiSize] = {0};
+
+        /** A struct array for storing user commands and their corresponding fn pointers */
+        TerminalCommanderTypes::user_callback_char_t userCharCallbacks[MaxCommands] = {};
+
+        /** Fixed array for staging terminal output before it is written to the Stream */
+        uint8_t outputBuffer[OutSize] = {0};
+    };
+
+    /** @brief Terminal sized by the TERM_CHAR_BUFFER_SIZE, MAX_USER_COMMANDS,
+     *         TERM_TWOWIRE_BUFFER_SIZE and TERM_OUTPUT_BUFFER_SIZE defaults */
+    typedef BasicTerminal<TERM_CHAR_BUFFER_SIZE, MAX_USER_COMMANDS, TERM_TWOWIRE_BUFFER_SIZE> Terminal;
   }
 #endif